@@ -0,0 +1,306 @@
+/*
+    CONNECT 4 - ENGINE MICROBENCHMARKS
+        Times each engine primitive on its own, over a fixed set of random but
+        realistic positions (games played with safe random moves, no finished
+        games), so a speedup can be attributed to the function it touched.
+
+        Build:  g++ -O3 -pthread -o microbench bench/microbench.cpp
+        Run:    ./microbench [--positions 2000] [--reps 15] [--warmup 3] [--seed N] [--filter name]
+*/
+
+#include <functional>
+
+#define CONNECT4_NO_MAIN
+#include "../main.cpp"
+
+// --- POSITIONS ---
+
+struct BenchPosition {
+    char b[ROWS][COLS];
+    char toMove;
+    uint64_t key;       // transpositionKey, as minimax builds it
+};
+
+vector<BenchPosition> randomPositions(int count, mt19937& rng) {
+    vector<BenchPosition> positions;
+    while ((int)positions.size() < count) {
+        BenchPosition p;
+        for (int i = 0; i < ROWS; i++) for (int j = 0; j < COLS; j++) p.b[i][j] = ' ';
+        int plies = uniform_int_distribution<int>(0, ROWS * COLS - 6)(rng);
+        char piece = 'X';
+        bool finished = false;
+        for (int ply = 0; ply < plies && !finished; ply++) {
+            int col = randomSafeColumn(p.b, piece, false, rng);
+            p.b[getNextOpenRow(p.b, col)][col] = piece;
+            finished = checkWin(p.b, piece);
+            piece = (piece == 'X') ? 'O' : 'X';
+        }
+        if (finished) continue;
+        p.toMove = piece;
+        p.key = transpositionKey(p.b, piece == 'O');
+        positions.push_back(p);
+    }
+    return positions;
+}
+
+// Playout g of runPlayouts replayed on a char board with the same random stream
+PlayoutResult referencePlayout(const BenchPosition& p, bool scoreAttack, uint64_t rng) {
+    char b[ROWS][COLS];
+    memcpy(b, p.b, sizeof(b));
+    char piece = p.toMove, last = ' ';
+    int plies = 0;
+    bool won = false;
+    while (true) {
+        bool full = true;
+        for (int c = 0; c < COLS; c++) full = full && getNextOpenRow(b, c) == -1;
+        if (full) break;
+        int col;
+        do col = (int)(((xorshiftNext(rng) >> 32) * COLS) >> 32); while (getNextOpenRow(b, col) == -1);
+        b[getNextOpenRow(b, col)][col] = piece;
+        plies++;
+        last = piece;
+        if (!scoreAttack && checkWin(b, piece)) { won = true; break; }
+        piece = (piece == 'X') ? 'O' : 'X';
+    }
+    PlayoutResult r;
+    r.plies = (uint8_t)plies;
+    r.xLines = (uint8_t)countLines(b, 'X');
+    r.oLines = (uint8_t)countLines(b, 'O');
+    if (scoreAttack) r.winner = r.xLines > r.oLines ? 'X' : (r.oLines > r.xLines ? 'O' : ' ');
+    else r.winner = won ? last : ' ';
+    return r;
+}
+
+// --- HARNESS ---
+// One repetition = one pass over every position. Warmup passes are not timed.
+
+struct MicroResult {
+    string name;
+    uint64_t callsPerRep = 0;
+    double meanNs = 0, medianNs = 0, minNs = 0, stddevNs = 0; // Per call
+};
+
+volatile uint64_t sink; // Results are folded in here so no call can be optimized away
+
+MicroResult summarize(const string& name, vector<double>& perCall, uint64_t calls) {
+    MicroResult res;
+    res.name = name;
+    res.callsPerRep = calls;
+    sort(perCall.begin(), perCall.end());
+    for (double v : perCall) res.meanNs += v;
+    res.meanNs /= perCall.size();
+    res.medianNs = perCall[perCall.size() / 2];
+    res.minNs = perCall[0];
+    for (double v : perCall) res.stddevNs += (v - res.meanNs) * (v - res.meanNs);
+    res.stddevNs = sqrt(res.stddevNs / perCall.size());
+    return res;
+}
+
+template <typename F>
+MicroResult measure(const string& name, vector<BenchPosition>& positions, int warmup, int reps, F body) {
+    uint64_t acc = 0, calls = 0;
+    for (int w = 0; w < warmup; w++) for (auto& p : positions) acc += body(p);
+
+    vector<double> perCall;
+    for (int r = 0; r < reps; r++) {
+        calls = 0;
+        auto start = chrono::steady_clock::now();
+        for (auto& p : positions) { acc += body(p); calls++; }
+        double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+        perCall.push_back(ns / max<uint64_t>(calls, 1));
+    }
+    sink = sink + acc;
+    return summarize(name, perCall, calls);
+}
+
+// Whole-array kernels (evaluateBatch): one timed call per pass, reported per position
+template <typename F>
+MicroResult measureBatch(const string& name, size_t count, int warmup, int reps, F pass) {
+    uint64_t acc = 0;
+    for (int w = 0; w < warmup; w++) acc += pass();
+
+    vector<double> perCall;
+    for (int r = 0; r < reps; r++) {
+        auto start = chrono::steady_clock::now();
+        acc += pass();
+        double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+        perCall.push_back(ns / max<size_t>(count, 1));
+    }
+    sink = sink + acc;
+    return summarize(name, perCall, count);
+}
+
+void printResult(const MicroResult& r) {
+    printf("  %-22s %10.1f %10.1f %10.1f %7.1f%% %9llu\n", r.name.c_str(), r.meanNs, r.medianNs, r.minNs,
+           100.0 * r.stddevNs / max(r.meanNs, 1e-9), (unsigned long long)r.callsPerRep);
+}
+
+// --- PRIMITIVES ---
+
+int main(int argc, char** argv) {
+    int count = getNumberArg<int>(argc, argv, "--positions", 2000);
+    int reps = max(1, getNumberArg<int>(argc, argv, "--reps", 15));
+    int warmup = getNumberArg<int>(argc, argv, "--warmup", 3);
+    string filter = getArgValue(argc, argv, "--filter", "");
+    mt19937 rng(parseSeed(argc, argv));
+    vector<BenchPosition> positions = randomPositions(count, rng);
+
+    // Memo entries for the probe benchmarks: every other position is present,
+    // so probes see both hits and misses.
+    for (size_t i = 0; i < positions.size(); i += 2) storeMemo(positions[i].key, memoEntry(3, (int)i, BOUND_EXACT, 6));
+    // The global eval cache is never sized here, so getOptimizedMoves measures
+    // raw evaluation; the cache itself is timed on a private instance.
+    EvalCache cache;
+    cache.resize(DEFAULT_EVAL_CACHE_MB);
+    TranspositionTable table;
+    table.resize(DEFAULT_TT_MB);
+    TranspositionTable bigTable; // Main tier far beyond the caches, as on a server
+    bigTable.resize(1024);
+
+    vector<pair<string, function<uint64_t(BenchPosition&)>>> benches = {
+        {"checkWin", [](BenchPosition& p) { return (uint64_t)checkWin(p.b, 'X') + checkWin(p.b, 'O'); }},
+        {"getNextOpenRow x7", [](BenchPosition& p) {
+            uint64_t s = 0;
+            for (int c = 0; c < COLS; c++) s += getNextOpenRow(p.b, c) + 1;
+            return s;
+        }},
+        {"evaluateWindow x69", [](BenchPosition& p) { // Every 4-cell window, as evaluateBoard scans them
+            uint64_t s = 0;
+            for (int r = 0; r < ROWS; r++) for (int c = 0; c < COLS - 3; c++)
+                s += evaluateWindow(p.b[r][c], p.b[r][c+1], p.b[r][c+2], p.b[r][c+3], 'O');
+            for (int r = 0; r < ROWS - 3; r++) for (int c = 0; c < COLS; c++)
+                s += evaluateWindow(p.b[r][c], p.b[r+1][c], p.b[r+2][c], p.b[r+3][c], 'O');
+            for (int r = 0; r < ROWS - 3; r++) for (int c = 0; c < COLS - 3; c++) {
+                s += evaluateWindow(p.b[r][c], p.b[r+1][c+1], p.b[r+2][c+2], p.b[r+3][c+3], 'O');
+                s += evaluateWindow(p.b[r+3][c], p.b[r+2][c+1], p.b[r+1][c+2], p.b[r][c+3], 'O');
+            }
+            return s;
+        }},
+        {"evaluateBoard", [](BenchPosition& p) { return (uint64_t)evaluateBoard(p.b, 'O'); }},
+        {"countThreats", [](BenchPosition& p) { return (uint64_t)countThreats(p.b, p.toMove); }},
+        {"getOptimizedMoves", [](BenchPosition& p) { return (uint64_t)getOptimizedMoves(p.b, p.toMove == 'O')[0]; }},
+        {"getPositionKey", [](BenchPosition& p) { return getPositionKey(p.b); }},
+        {"toBitPosition", [](BenchPosition& p) { return toBitPosition(p.b).mask; }},
+        {"memo probe", [](BenchPosition& p) {
+            MemoEntry e;
+            return (uint64_t)(probeMemo(p.key, 6, e) ? e.score : 0);
+        }},
+        {"memo store", [](BenchPosition& p) {
+            storeMemo(p.key, memoEntry(3, 0, BOUND_LOWER, 6));
+            return (uint64_t)1;
+        }},
+        {"transpositionKey", [](BenchPosition& p) { return transpositionKey(p.b, p.toMove == 'O'); }},
+        {"TT probe+store", [&table](BenchPosition& p) {
+            uint64_t key = transpositionKey(p.b, p.toMove == 'O');
+            MemoEntry e;
+            if (table.find(key, 6, e)) return (uint64_t)e.score;
+            table.store(key, memoEntry(3, 1, BOUND_EXACT, 6));
+            return (uint64_t)0;
+        }},
+        {"1GB TT hot tier", [&bigTable](BenchPosition& p) { // Shallow node
+            uint64_t key = transpositionKey(p.b, p.toMove == 'O');
+            MemoEntry e;
+            if (bigTable.find(key, 1, e)) return (uint64_t)e.score;
+            bigTable.store(key, memoEntry(3, 1, BOUND_EXACT, 1));
+            return (uint64_t)0;
+        }},
+        {"1GB TT main tier", [&bigTable](BenchPosition& p) { // Deep node
+            uint64_t key = transpositionKey(p.b, p.toMove == 'O') ^ 1;
+            MemoEntry e;
+            if (bigTable.find(key, 6, e)) return (uint64_t)e.score;
+            bigTable.store(key, memoEntry(3, 1, BOUND_EXACT, 6));
+            return (uint64_t)0;
+        }},
+        {"evalCache probe+store", [&cache](BenchPosition& p) {
+            uint64_t key = EvalCache::slotKey(getPositionKey(p.b), 'O');
+            int score;
+            if (cache.probe(key, score)) return (uint64_t)score;
+            cache.store(key, 1);
+            return (uint64_t)0;
+        }},
+        {"calculateFinalScore", [](BenchPosition& p) { // Reads the global board, so the copy is included
+            memcpy(board, p.b, sizeof(board));
+            return (uint64_t)calculateFinalScore('X') + calculateFinalScore('O');
+        }},
+    };
+
+    // Struct-of-arrays copy for the batch evaluator, scored from both sides.
+    // It must agree with evaluateBoard on every position before it is timed.
+    size_t lanes = positions.size() * 2;
+    vector<uint64_t> own(lanes), opp(lanes);
+    vector<int32_t> batchScores(lanes);
+    for (size_t i = 0; i < positions.size(); i++) {
+        BitPosition bits = toBitPosition(positions[i].b);
+        own[2 * i] = bits.o;  opp[2 * i] = bits.x;
+        own[2 * i + 1] = bits.x;  opp[2 * i + 1] = bits.o;
+    }
+    evaluateBatch(own.data(), opp.data(), lanes, batchScores.data());
+    for (size_t i = 0; i < lanes; i++) {
+        int expected = evaluateBoard(positions[i / 2].b, i % 2 ? 'X' : 'O');
+        if (evaluateBits(own[i], opp[i]) != expected || batchScores[i] != expected) {
+            printf(" Batch evaluation disagrees with evaluateBoard on position %zu\n", i / 2);
+            return 1;
+        }
+    }
+
+    // Playouts from a sample of the positions, in both rule sets, against the char-board replay
+    for (size_t i = 0; i < positions.size(); i += 50) {
+        for (bool scoreAttack : {false, true}) {
+            PlayoutResult got[19];
+            runPlayouts(toBitPosition(positions[i].b), positions[i].toMove, scoreAttack, i, 19, got);
+            for (int g = 0; g < 19; g++) {
+                PlayoutResult want = referencePlayout(positions[i], scoreAttack, playoutSeed(i, g));
+                if (got[g].winner != want.winner || got[g].plies != want.plies ||
+                    got[g].xLines != want.xLines || got[g].oLines != want.oLines) {
+                    printf(" Playout %d from position %zu disagrees with the reference\n", g, i);
+                    return 1;
+                }
+            }
+        }
+    }
+
+    printf(" Microbenchmarks: %zu positions, %d warmup + %d timed passes (ns per call)\n", positions.size(), warmup, reps);
+    printf("  %-22s %10s %10s %10s %8s %9s\n", "primitive", "mean", "median", "min", "stddev", "calls");
+    for (auto& bench : benches) {
+        if (!filter.empty() && bench.first.find(filter) == string::npos) continue;
+        printResult(measure(bench.first, positions, warmup, reps, bench.second));
+    }
+    // Per position, over both sides of every position
+    if (filter.empty() || string("evaluateBits").find(filter) != string::npos)
+        printResult(measureBatch("evaluateBits", lanes, warmup, reps, [&]() {
+            uint64_t s = 0;
+            for (size_t i = 0; i < lanes; i++) s += evaluateBits(own[i], opp[i]);
+            return s;
+        }));
+    string batchName = batchUsesAVX2() ? "evaluateBatch (AVX2)" : "evaluateBatch";
+    if (filter.empty() || batchName.find(filter) != string::npos)
+        printResult(measureBatch(batchName, lanes, warmup, reps, [&]() {
+            evaluateBatch(own.data(), opp.data(), lanes, batchScores.data());
+            return (uint64_t)batchScores[lanes / 2];
+        }));
+
+    // Per playout, classic rules from the empty board
+    const size_t games = 100000;
+    vector<PlayoutResult> outcomes(games);
+    BitPosition empty;
+    uint64_t playoutPass = 0;
+    if (filter.empty() || string("playoutScalar").find(filter) != string::npos)
+        printResult(measureBatch("playoutScalar", games, warmup, reps, [&]() {
+            uint64_t s = 0, seed = ++playoutPass;
+            for (size_t g = 0; g < games; g++) s += playoutScalar(empty, 'X', false, playoutSeed(seed, g)).plies;
+            return s;
+        }));
+    string playoutName = batchUsesAVX2() ? "runPlayouts (AVX2)" : "runPlayouts";
+    if (filter.empty() || playoutName.find(filter) != string::npos) {
+        MicroResult r = measureBatch(playoutName, games, warmup, reps, [&]() {
+            runPlayouts(empty, 'X', false, ++playoutPass, games, outcomes.data());
+            return (uint64_t)outcomes[games / 2].plies;
+        });
+        printResult(r);
+        size_t xWins = 0, oWins = 0;
+        for (auto& o : outcomes) { xWins += o.winner == 'X'; oWins += o.winner == 'O'; }
+        printf("  %.1fM playouts/s on one core; last pass: X %.1f%%, O %.1f%%, draws %.1f%%\n", 1e3 / r.medianNs,
+               100.0 * xWins / games, 100.0 * oWins / games, 100.0 * (games - xWins - oWins) / games);
+    }
+    return 0;
+}
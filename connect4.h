@@ -0,0 +1,93 @@
+/*
+    CONNECT 4 - C API
+        Stable C ABI for calling the engine in-process from other languages.
+        Contexts are opaque; every call is synchronous and a context must not
+        be used from two threads at once (create one per thread instead).
+        Scores are from the point of view of the side to move.
+
+        Build:  g++ -O3 -pthread -shared -fPIC -fvisibility=hidden -DCONNECT4_NO_MAIN main.cpp -o libconnect4.so
+*/
+
+#ifndef CONNECT4_C_API_H
+#define CONNECT4_C_API_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+    #define C4_API __declspec(dllexport)
+#else
+    #define C4_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define C4_API_VERSION 3
+
+/* Return codes (and per-position statuses of c4_evaluate_batch) */
+#define C4_OK                0
+#define C4_INVALID_MOVES    -1  /* Not a legal sequence of 1-based columns */
+#define C4_GAME_OVER        -2  /* Someone has four in a row, or the board is full */
+#define C4_INVALID_ARGUMENT -3
+
+typedef struct c4_engine c4_engine;
+
+/* Zero means "no limit"; at least one of depth, time_ms and nodes must be set */
+typedef struct {
+    int32_t depth;        /* Deepest iterative-deepening iteration */
+    int32_t time_ms;
+    uint64_t nodes;
+    int32_t score_attack; /* Nonzero: Score Attack rules instead of Classic */
+} c4_limits;
+
+typedef struct {
+    int32_t column;       /* 0-based column to play */
+    int32_t score;        /* Side to move's score (0 when the move came from the win/block scan) */
+    int32_t depth;        /* Deepest iteration that finished */
+    uint64_t nodes;
+    double ms;
+} c4_search_result;
+
+C4_API int32_t c4_api_version(void);
+
+/* Version 2: moves every context's transposition table into the POSIX shared-memory
+   segment 'name' ("/connect4-tt"), creating it with tt_mb megabytes if it does not
+   exist (an existing segment keeps its size), so every process on the host that
+   attaches it shares analysis. Call once, ideally before the first search; a second
+   call fails and the first table stays. On error the process keeps private tables. */
+C4_API int32_t c4_attach_shared_table(const char* name, int32_t tt_mb);
+
+C4_API c4_engine* c4_create(void);
+C4_API void c4_destroy(c4_engine* engine);
+
+/* Replaces the context's position with the game "moves" (1-based columns, X first; "" = empty
+   board). On error the position is unchanged. */
+C4_API int32_t c4_set_position(c4_engine* engine, const char* moves);
+
+/* Searches the current position for the side to move */
+C4_API int32_t c4_search(c4_engine* engine, const c4_limits* limits, c4_search_result* result);
+
+/*
+    Scores 'count' positions in one call. depth 0 is the static evaluation
+    for the side to move. depth d > 0 is a fixed-depth search whose leaves
+    are scored the same way, for the side to move at the leaf, so a quiet
+    position's depth-d score is negamax over the depth-0 scores d plies
+    down. (The static evaluation is not antisymmetric: a leaf is never
+    scored as minus the other side's view.) Wins found by the search score
+    +/-(1000000 + plies left), and in classic mode a single forced reply is
+    searched one ply deeper. A score never reuses a deeper search from an
+    earlier call. c4_search scores the same way. scores[i] and statuses[i]
+    (C4_OK, C4_INVALID_MOVES or C4_GAME_OVER, with score 0) are written for
+    every i; the arrays are owned by the caller. The context's position is
+    unchanged.
+*/
+C4_API int32_t c4_evaluate_batch(c4_engine* engine, const char* const* moves, size_t count, int32_t depth,
+                                 int32_t score_attack, int32_t* scores, int32_t* statuses);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONNECT4_C_API_H */
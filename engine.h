@@ -0,0 +1,88 @@
+/*
+    CONNECT 4 - ENGINE LIBRARY API
+        Asynchronous AI moves for embedding the engine in event-driven code.
+        A request returns at once with a future; the engine's worker pool
+        searches the position and completes it (and calls onComplete, if set,
+        on the worker thread). Requests can be cancelled and given deadlines.
+
+        The library is main.cpp built without its console front-end:
+            g++ -O3 -pthread -DCONNECT4_NO_MAIN -c main.cpp -o connect4_engine.o
+            ar rcs libconnect4.a connect4_engine.o
+            g++ -O3 -pthread your_server.cpp libconnect4.a
+*/
+
+#ifndef CONNECT4_ENGINE_H
+#define CONNECT4_ENGINE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+
+enum MoveStatus {
+    MOVE_DONE,       // Searched to the level's budget, the depth or the deadline
+    MOVE_CANCELLED,  // cancel() was called; 'column' is the best move found so far, if any
+    MOVE_EXPIRED,    // The deadline passed before a worker picked the request up
+    MOVE_INVALID,    // Illegal move string, or the game is already over
+};
+
+struct MoveResult {
+    MoveStatus status = MOVE_INVALID;
+    int column = -1;          // 0-based column to play (-1 if none)
+    int score = 0;            // Root score, 'O' maximizes (valid when 'scored')
+    bool scored = false;      // False when the move came from the win/block scan or a random level move
+    uint64_t nodes = 0;
+    uint64_t searchHash = 0;  // Deterministic mode: trace of every visited node
+    double queuedMs = 0;      // Waiting for a worker
+    double searchMs = 0;
+};
+
+struct MoveRequest {
+    std::string moves;        // Game so far as 1-based columns ("4453"), X moved first
+    int level = 2;            // Difficulty profile, 1 (EASY) to 4 (EXPERT)
+    int depth = 0;            // > 0: search to this depth instead of a level's budget
+    bool scoreAttack = false;
+    std::chrono::milliseconds deadline{0}; // From submission; 0 = none
+    uint64_t seed = 0;        // Level randomness (eval noise, random moves)
+    std::function<void(const MoveResult&)> onComplete; // Runs on the worker thread
+};
+
+struct PendingMove {
+    std::future<MoveResult> result;
+    std::shared_ptr<std::atomic<bool>> cancelFlag;
+
+    // Ends the search at its next check; the future still completes
+    void cancel() { cancelFlag->store(true); }
+};
+
+class Engine {
+public:
+    // 0 workers = one per hardware thread. Each request is searched by one
+    // worker with 'searchThreads' root-parallel threads.
+    explicit Engine(int workers = 0, int searchThreads = 1);
+    ~Engine(); // Cancels queued and running requests, then joins the workers
+
+    Engine(const Engine&) = delete;
+    Engine& operator=(const Engine&) = delete;
+
+    PendingMove requestMove(MoveRequest request);
+    int workerCount() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl;
+    void workerLoop();
+};
+
+// Moves the transposition table of every search in this process into the POSIX
+// shared-memory segment 'name' ("/connect4-tt"), created with these sizes if it
+// does not exist yet, so all processes on the host that attach it share their
+// analysis. Call once, ideally before the first request; a second call fails
+// and the first table stays. On false ('error' says why) the engine keeps the
+// tables it had.
+bool attachSharedTable(const std::string& name, int megabytes, int hotKilobytes, std::string& error);
+
+#endif // CONNECT4_ENGINE_H
@@ -5,6 +5,16 @@
         - Heuristics: Gravity-aware evaluation, strategic pattern recognition.
         - Optimization: Transposition table (memory cache) & dynamic move ordering.
         - Safety: Input validation and bounded memory usage.
+        - Tools: Multi-threaded self-play training data generator (--selfplay).
+        - Tools: Fixed-position search benchmark (--bench).
+        - Tools: Tuned-vs-baseline engine match with Elo estimate (--match).
+        - Tools: Concurrent-games load generator for capacity planning (--loadgen).
+        - Tools: Tiled spectator dashboard of many live AI games (--arena).
+        - Tools: Exact solver for classic positions (--solve), regression-tested on known values.
+        - Tools: Distributed solving over Unix or TCP sockets (--coordinator, --solve-worker).
+        - Optimization: Transposition table shared by engine processes on a host (--tt-shm).
+        - Library: Asynchronous move API with a worker pool (engine.h); build with -DCONNECT4_NO_MAIN.
+        - Library: C ABI shared library with batch evaluation (connect4.h).
         - Compatibility: Works on Linux (Native) & Windows (Auto-Color Fix).
 */
 
@@ -18,6 +28,24 @@
 #include <string>
 #include <fstream> 
 #include <random>
+#include <cstdint>
+#include <cmath>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <unordered_set>
+#include <chrono>
+#include <memory>
+#include <queue>
+#include <condition_variable>
+#include <csignal>
+#include <cstring>
+#include <sstream>
+#include <iomanip>
+#include <deque>
+
+#include "engine.h"
+#include "connect4.h"
 
 // --- WINDOWS COMPATIBILITY BLOCK ---
 #ifdef _WIN32
@@ -25,6 +53,28 @@
     #ifndef ENABLE_VIRTUAL_TERMINAL_PROCESSING
     #define ENABLE_VIRTUAL_TERMINAL_PROCESSING 0x0004
     #endif
+#else
+    #include <unistd.h>
+    #include <sys/ioctl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <cerrno>
+    #include <sys/socket.h>
+    #include <sys/un.h>
+    #include <sys/wait.h>
+    #include <netinet/in.h>
+    #include <netdb.h>
+    #include <poll.h>
+#endif
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #include <immintrin.h>
+    #define HAS_AVX2_BATCH 1
+#endif
+#ifdef __linux__
+    #include <linux/perf_event.h>
+    #include <sys/syscall.h>
+    #include <cerrno>
 #endif
 
 using namespace std;
@@ -32,7 +82,6 @@ using namespace std;
 // --- CONFIGURATION ---
 const int ROWS = 6;
 const int COLS = 7;
-const int MAX_MEMORY_SIZE = 2000000; 
 
 // Colors
 const string RED = "\033[31m";
@@ -43,8 +92,406 @@ const string CLEAR_SCREEN = "\033[2J\033[1;1H";
 
 char board[ROWS][COLS];
 
-// MEMORY CACHE
-unordered_map<string, pair<int, int>> memo;
+// CPU DISPATCH: hot kernels marked HOT_KERNEL are compiled for x86-64-v3
+// (AVX2, BMI2, FMA, MOVBE...), for POPCNT only and for baseline x86-64; the
+// ifunc resolver picks one at load time from the CPU's feature bits, so one
+// binary runs everywhere. "arch=haswell" would not do: its resolver matches the
+// CPU model, so Skylake, Zen and later AVX2 parts would fall back to popcnt.
+// The x86-64-v3 resolver and __builtin_cpu_supports("x86-64-v3") need GCC 12.
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 12 && (defined(__x86_64__) || defined(__i386__)) && defined(__linux__)
+    #define HOT_KERNEL_DISPATCH
+    #define HOT_KERNEL __attribute__((target_clones("arch=x86-64-v3", "popcnt", "default")))
+#else
+    #define HOT_KERNEL
+#endif
+
+// Which HOT_KERNEL variant this machine runs, for bench output; the tests are
+// the ones the resolver makes, in the same order
+string cpuKernelVariant() {
+    #ifdef HOT_KERNEL_DISPATCH
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("x86-64-v3")) return "x86-64-v3 (AVX2/BMI2/POPCNT)";
+        if (__builtin_cpu_supports("popcnt")) return "popcnt";
+        return "baseline x86-64";
+    #else
+        return "single build";
+    #endif
+}
+
+// MEMORY CACHE (one per thread, so self-play workers never share it)
+// Scores found with a narrowed alpha-beta window are only bounds, so each entry
+// remembers which kind it is and is reused only where that bound still decides.
+// Entries are keyed by position and side and remember the depth they were
+// searched to, so they stay useful across moves wherever that depth suffices.
+// Each move starts a new generation; full slots give way to older generations first.
+enum MemoBound : int8_t { BOUND_EXACT, BOUND_LOWER, BOUND_UPPER };
+
+struct MemoEntry {
+    int col;
+    int score;
+    MemoBound bound;
+    int depth = 0;           // Remaining depth searched (after the endgame override)
+    uint8_t generation = 0;
+};
+
+const uint8_t GENERATION_MASK = 15; // Generations fit in 4 bits of a packed entry
+thread_local uint8_t searchGeneration = 0;
+
+// Called once per move (not per iteration), so entries from earlier moves age
+void newSearchGeneration() {
+    searchGeneration = (searchGeneration + 1) & GENERATION_MASK;
+}
+
+// Keep 'incoming' over 'existing' for the same position? Without 'byGeneration'
+// only depth decides (generations from other processes mean nothing here).
+bool replacesEntry(const MemoEntry& existing, const MemoEntry& incoming, bool byGeneration = true) {
+    return (byGeneration && existing.generation != incoming.generation) || incoming.depth >= existing.depth;
+}
+
+// Every entry is one 64-bit word (an unordered_map<string, ...> node cost
+// ~150 bytes), so the same memory holds ~20x more positions:
+//   bits  0-27  score as fours * FOUR_SCORE + remainder (8 + 20 bits), lossless
+//               for every score the search produces: a four is worth
+//               FOUR_SCORE in evaluateWindow and wins are FOUR_SCORE - plies
+//   bits 28-30  col + 1        bits 31-32  bound + 1 (never 0: marks a used slot)
+//   bits 33-38  depth          bits 39-42  generation
+//   bits 43-63  key check: the 21 top bits of the slot hash, which the index never uses
+const int FOUR_SCORE = 1000000;
+const int PACKED_REMAINDER_BIAS = 1 << 19;
+const int PACKED_FOURS_BIAS = 128;
+const int KEY_CHECK_SHIFT = 43;
+
+// Slot hash for the lock-free tables: a full 64-bit mix (MurmurHash3's
+// finalizer), so every key bit reaches the low bits a small table keeps.
+// A plain multiply leaves them depending only on the low (left-hand) columns.
+uint64_t slotIndex(uint64_t key) {
+    key ^= key >> 33;
+    key *= 0xFF51AFD7ED558CCDULL;
+    key ^= key >> 33;
+    key *= 0xC4CEB9FE1A85EC53ULL;
+    return key ^ (key >> 33);
+}
+
+// False (entry not stored) for scores beyond +-127 fours, which no position reaches
+bool packMemoEntry(uint64_t hash, const MemoEntry& e, uint64_t& word) {
+    int fours = (e.score + (e.score >= 0 ? FOUR_SCORE / 2 : -FOUR_SCORE / 2)) / FOUR_SCORE;
+    if (fours < -PACKED_FOURS_BIAS || fours >= PACKED_FOURS_BIAS) return false;
+    int remainder = e.score - fours * FOUR_SCORE;
+    word = (uint64_t)(remainder + PACKED_REMAINDER_BIAS) | (uint64_t)(fours + PACKED_FOURS_BIAS) << 20
+         | (uint64_t)((e.col + 1) & 7) << 28 | (uint64_t)(e.bound + 1) << 31 | (uint64_t)(e.depth & 63) << 33
+         | (uint64_t)(e.generation & GENERATION_MASK) << 39 | (hash >> KEY_CHECK_SHIFT) << KEY_CHECK_SHIFT;
+    return true;
+}
+
+MemoEntry unpackMemoEntry(uint64_t word) {
+    int fours = (int)((word >> 20) & 0xFF) - PACKED_FOURS_BIAS;
+    int remainder = (int)(word & 0xFFFFF) - PACKED_REMAINDER_BIAS;
+    MemoEntry e = {(int)((word >> 28) & 7) - 1, fours * FOUR_SCORE + remainder, (MemoBound)(((word >> 31) & 3) - 1)};
+    e.depth = (int)((word >> 33) & 63);
+    e.generation = (uint8_t)((word >> 39) & GENERATION_MASK);
+    return e;
+}
+
+bool packedEntryMatches(uint64_t word, uint64_t hash) {
+    return ((word >> 31) & 3) != 0 && (word >> KEY_CHECK_SHIFT) == (hash >> KEY_CHECK_SHIFT);
+}
+
+// The table is shared lock-free by threads searching the same tree
+// (root-parallel search). Each entry is a single atomic word, so it can't be
+// torn; a probe only trusts it when the key check bits match.
+//
+// Two tiers: shallow nodes (the vast majority of probes and stores) live in a
+// small hot tier that stays in L2/L3, so a large main table is only touched by
+// the deeper nodes whose entries are worth a cache miss.
+const int DEFAULT_TT_MB = 32;
+const int DEFAULT_HOT_TT_KB = 512;   // --tt-hot-kb; 0 sends every entry to the main tier
+const int HOT_TT_MAX_DEPTH = 2;      // Remaining depth served by the hot tier
+
+enum TTHit { TT_MISS, TT_HOT, TT_MAIN };
+
+// Slots for a tier of about 'bytes': a power of two, at least one
+size_t tierSlots(size_t bytes) {
+    size_t count = 1;
+    while (count * 2 <= bytes / sizeof(uint64_t)) count *= 2;
+    return count;
+}
+
+struct TTTier {
+    unique_ptr<atomic<uint64_t>[]> owned; // Private tables; a shared one points into its segment
+    atomic<uint64_t>* entries = nullptr;
+    size_t slotCount = 0;
+    uint64_t indexMask = 0;
+
+    void resize(size_t bytes) {
+        size_t count = tierSlots(bytes);
+        owned.reset(new atomic<uint64_t>[count]()); // Zeroed: every slot empty
+        attach(owned.get(), count);
+    }
+
+    // Uses 'count' (a power of two) slots owned by someone else
+    void attach(atomic<uint64_t>* slots, size_t count) {
+        entries = slots;
+        slotCount = count;
+        indexMask = count - 1;
+    }
+
+    bool empty() const { return slotCount == 0; }
+
+    void clear() {
+        for (size_t i = 0; i < slotCount; i++) entries[i].store(0, memory_order_relaxed);
+    }
+
+    bool find(uint64_t key, MemoEntry& out) {
+        uint64_t hash = slotIndex(key);
+        uint64_t word = entries[hash & indexMask].load(memory_order_relaxed);
+        if (!packedEntryMatches(word, hash)) return false;
+        out = unpackMemoEntry(word);
+        return true;
+    }
+
+    // One entry per slot. 'alwaysReplace' lets the newest entry win; otherwise
+    // an empty slot, an older generation (if 'byGeneration') or a search at
+    // least as deep takes it over and a deeper current entry stays.
+    void store(uint64_t key, const MemoEntry& entry, bool alwaysReplace, bool byGeneration = true) {
+        uint64_t hash = slotIndex(key), word;
+        if (!packMemoEntry(hash, entry, word)) return;
+        atomic<uint64_t>& slot = entries[hash & indexMask];
+        if (!alwaysReplace) {
+            uint64_t old = slot.load(memory_order_relaxed);
+            if (old != 0 && !replacesEntry(unpackMemoEntry(old), entry, byGeneration)) return;
+        }
+        slot.store(word, memory_order_relaxed);
+    }
+};
+
+struct TranspositionTable {
+    TTTier hot;   // Depth <= HOT_TT_MAX_DEPTH, always replace: shallow entries go stale fast
+    TTTier main;  // Deeper nodes, depth- and generation-preferred
+    bool hotEnabled = false;
+    bool ageByGeneration = true; // False for the host table: depth alone decides
+
+    void resize(int megabytes, int hotKilobytes = DEFAULT_HOT_TT_KB) {
+        hotEnabled = hotKilobytes > 0;
+        hot.resize(hotEnabled ? (size_t)hotKilobytes * 1024 : 0);
+        main.resize((size_t)max(megabytes, 0) * 1024 * 1024);
+    }
+
+    void clear() {
+        hot.clear();
+        main.clear();
+    }
+
+    // A position is stored and probed in the tier chosen by its remaining
+    // depth, so each probe touches exactly one tier.
+    bool inHotTier(int depth) const { return hotEnabled && depth <= HOT_TT_MAX_DEPTH; }
+
+    TTHit find(uint64_t key, int depth, MemoEntry& out) {
+        if (inHotTier(depth)) return hot.find(key, out) ? TT_HOT : TT_MISS;
+        return main.find(key, out) ? TT_MAIN : TT_MISS;
+    }
+
+    void store(uint64_t key, const MemoEntry& entry) {
+        if (inHotTier(entry.depth)) hot.store(key, entry, true);
+        else main.store(key, entry, false, ageByGeneration);
+    }
+};
+
+int tableMb = DEFAULT_TT_MB;                           // --tt-mb
+int hotTableKb = DEFAULT_HOT_TT_KB;                    // --tt-hot-kb
+thread_local TranspositionTable memo;                  // Allocated on this thread's first search
+thread_local TranspositionTable* sharedMemo = nullptr; // Set only inside root-parallel workers
+
+// Forget all memoized scores (new tuning, noise or mode)
+void clearMemo() {
+    if (!memo.main.empty()) memo.clear();
+}
+
+const uint64_t FNV_OFFSET = 1469598103934665603ULL;
+
+// SEARCH STATISTICS (per thread, reset by whoever starts a measured search)
+struct SearchStats {
+    uint64_t nodes = 0;
+    uint64_t evalCalls = 0;       // Full evaluateBoard computations
+    uint64_t evalCacheProbes = 0;
+    uint64_t evalCacheHits = 0;
+    uint64_t ttProbes = 0;        // Memo table
+    uint64_t ttHotHits = 0;       // Hits at a usable depth, by the tier that served them
+    uint64_t ttMainHits = 0;
+    uint64_t traceHash = FNV_OFFSET; // Deterministic mode: every visited node, in order
+    int rootScore = 0;               // Score of the chosen move ('O' maximizes), when searched
+    bool rootScored = false;         // False when the move came from the one-ply scan
+    int completedDepth = 0;          // Deepest finished search of the root
+};
+thread_local SearchStats searchStats;
+
+// SEARCH TUNING (heuristic levels only; exact endgame solving is never reduced)
+struct SearchTuning {
+    bool lateMoveReductions = false;
+    int lmrFullDepthMoves = 2;  // Best-ordered moves always searched at full depth
+    int lmrMinDepth = 3;        // No reductions this close to the horizon
+    int lmrReduction = 2;       // Plies removed from a late move's first search
+    bool futilityPruning = false;
+    int futilityMargin = 600;   // Per ply of remaining depth (depth <= 2 only)
+    bool nonLosingMoves = true; // Classic: never search moves that hand over an immediate win
+    int evalNoise = 0;          // Weaker levels: +/- this many points on every leaf evaluation
+    uint64_t noiseSeed = 0;     // Changes per move, so the noise isn't the same every turn
+    bool sideToMoveLeaves = false; // C API: leaves score the side to move, negated for 'X', as a depth-0 call does
+    bool exactDepthOnly = false;   // C API: a depth-d score never comes from an earlier call's deeper search
+};
+
+// SEARCH LIMITS (optional; an aborted search must not be trusted or memoized)
+struct SearchLimits {
+    bool hasDeadline = false;
+    chrono::steady_clock::time_point deadline;
+    uint64_t nodeLimit = 0;       // 0 = unlimited
+    atomic<uint64_t>* nodeCounter = nullptr; // Root-parallel workers: all workers' nodes, checked against nodeLimit
+    atomic<bool>* stop = nullptr; // Raised by another thread to end this search early
+};
+thread_local SearchLimits searchLimits;
+thread_local bool searchAborted = false;
+
+// Per-move budget for iterative deepening. Deterministic mode ignores the clock.
+struct SearchBudget {
+    int timeMs = 0;              // 0 = no time limit
+    uint64_t nodes = 0;          // 0 = no node limit
+    int maxDepth = ROWS * COLS;  // Deepest iteration
+    atomic<bool>* stop = nullptr; // Cancels the search from another thread
+};
+
+// DETERMINISTIC MODE: fixed seeds, node budgets instead of time, one search
+// thread and a fresh memo per search, so every run can be replayed exactly.
+bool deterministicMode = false;
+
+uint64_t fnv1a(uint64_t h, const void* data, size_t size) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    for (size_t i = 0; i < size; i++) { h ^= bytes[i]; h *= 1099511628211ULL; }
+    return h;
+}
+
+uint64_t fnv1a(uint64_t h, uint64_t value) {
+    return fnv1a(h, &value, sizeof(value));
+}
+
+SearchLimits limitsFor(const SearchBudget& budget) {
+    SearchLimits limits;
+    if (budget.timeMs > 0 && !deterministicMode) {
+        limits.hasDeadline = true;
+        limits.deadline = chrono::steady_clock::now() + chrono::milliseconds(budget.timeMs);
+    }
+    limits.nodeLimit = budget.nodes ? searchStats.nodes + budget.nodes : 0; // Node counter is cumulative
+    limits.stop = budget.stop;
+    return limits;
+}
+
+SearchTuning configuredTuning;                             // Set once from the command line
+thread_local SearchTuning searchTuning = configuredTuning;  // Worker threads start from it
+
+// HOST TABLE (--tt-shm NAME): one transposition table in a POSIX shared-memory
+// segment, used by every search thread of every process that attaches it. The
+// first process creates and sizes the segment; later ones adopt its size and
+// start with everything already analysed. The segment outlives the processes
+// (remove it with shm_unlink, or /dev/shm/NAME on Linux). Entries are the same
+// 8-byte words as a private table, so sharing them needs no locks. Generations
+// are a per-process counter and say nothing about another process's entries, so
+// the host table's main tier is depth-preferred: an entry gives way only to a
+// search at least as deep, whoever made either.
+struct SharedTableHeader {
+    atomic<uint64_t> magic;  // Stored last by the creator: the rest is valid
+    uint64_t hotSlots;
+    uint64_t mainSlots;
+    uint64_t reserved[5];    // Slots start on a cache line
+};
+
+const uint64_t SHARED_TABLE_MAGIC = 0x4334545400000001ULL; // "C4TT", layout version 1
+static_assert(atomic<uint64_t>::is_always_lock_free, "entries must be address-free to live in shared memory");
+
+TranspositionTable hostTable;
+atomic<bool> hostTableAttached(false); // Set (release) once hostTable is complete
+mutex hostTableLock;                   // Serializes attachSharedTable
+
+#ifndef _WIN32
+// Creates or opens the segment. False with 'error' set if it cannot be used, or
+// if a table is already attached: searches may be using it, so it stays.
+bool attachSharedTable(const string& name, int megabytes, int hotKilobytes, string& error) {
+    lock_guard<mutex> guard(hostTableLock);
+    if (hostTableAttached.load(memory_order_relaxed)) { error = "a shared table is already attached"; return false; }
+    bool created = true;
+    int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0 && errno == EEXIST) {
+        created = false;
+        fd = shm_open(name.c_str(), O_RDWR, 0600);
+    }
+    if (fd < 0) { error = string("shm_open: ") + strerror(errno); return false; }
+
+    size_t hotSlots = hotKilobytes > 0 ? tierSlots((size_t)hotKilobytes * 1024) : 0;
+    size_t mainSlots = tierSlots((size_t)max(megabytes, 0) * 1024 * 1024);
+    size_t bytes = sizeof(SharedTableHeader) + (hotSlots + mainSlots) * sizeof(uint64_t);
+    struct stat info;
+    if (created) {
+        if (ftruncate(fd, (off_t)bytes) != 0) { // New pages read as zero: every slot empty
+            error = string("ftruncate: ") + strerror(errno);
+            close(fd);
+            shm_unlink(name.c_str());
+            return false;
+        }
+    } else {
+        // The creator may still be sizing it
+        for (int wait = 0; fstat(fd, &info) == 0 && info.st_size < (off_t)sizeof(SharedTableHeader) && wait < 200; wait++)
+            this_thread::sleep_for(chrono::milliseconds(10));
+        if (fstat(fd, &info) != 0 || info.st_size < (off_t)sizeof(SharedTableHeader)) {
+            error = "segment was never sized";
+            close(fd);
+            return false;
+        }
+        bytes = (size_t)info.st_size;
+    }
+
+    void* base = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd); // The mapping keeps the segment
+    if (base == MAP_FAILED) { error = string("mmap: ") + strerror(errno); return false; }
+    SharedTableHeader* header = (SharedTableHeader*)base;
+    if (created) {
+        header->hotSlots = hotSlots;
+        header->mainSlots = mainSlots;
+        header->magic.store(SHARED_TABLE_MAGIC, memory_order_release);
+    } else {
+        for (int wait = 0; header->magic.load(memory_order_acquire) != SHARED_TABLE_MAGIC && wait < 200; wait++)
+            this_thread::sleep_for(chrono::milliseconds(10));
+        hotSlots = header->hotSlots;
+        mainSlots = header->mainSlots;
+        bool sane = header->magic.load(memory_order_acquire) == SHARED_TABLE_MAGIC && mainSlots > 0 &&
+                    (mainSlots & (mainSlots - 1)) == 0 && (hotSlots & (hotSlots - 1)) == 0 &&
+                    sizeof(SharedTableHeader) + (hotSlots + mainSlots) * sizeof(uint64_t) <= bytes;
+        if (!sane) {
+            error = "not a Connect 4 table segment (or a different layout version)";
+            munmap(base, bytes);
+            return false;
+        }
+    }
+
+    atomic<uint64_t>* slots = (atomic<uint64_t>*)(header + 1);
+    hostTable.hotEnabled = hotSlots > 0;
+    hostTable.ageByGeneration = false;
+    hostTable.hot.attach(slots, hotSlots);
+    hostTable.main.attach(slots + hotSlots, mainSlots);
+    hostTableAttached.store(true, memory_order_release); // Searches already running see a complete table
+    return true;
+}
+#else
+bool attachSharedTable(const string&, int, int, string& error) {
+    error = "shared-memory tables need a POSIX system";
+    return false;
+}
+#endif
+
+// The table this thread's search reads and writes. Searches that must not
+// share their entries (deterministic replays, noisy weak levels) stay private.
+TranspositionTable& activeMemo() {
+    if (sharedMemo) return *sharedMemo;
+    if (hostTableAttached.load(memory_order_acquire) && !deterministicMode && searchTuning.evalNoise == 0) return hostTable;
+    if (memo.main.empty()) memo.resize(tableMb, hotTableKb);
+    return memo;
+}
 
 // --- SYSTEM SETUP ---
 
@@ -69,11 +516,88 @@ void initBoard() {
         for (int j = 0; j < COLS; j++) board[i][j] = ' '; 
 }
 
-string getBoardHash(char b[ROWS][COLS]) {
-    string key = "";
-    for (int i = 0; i < ROWS; i++) 
-        for (int j = 0; j < COLS; j++) key += b[i][j];
-    return key;
+// Compact 64-bit key: 'O' pieces + filled mask + bottom row, laid out column by column
+// with one sentinel bit on top of each column (7 bits x 7 columns = 49 bits, unique per position).
+const int COL_BITS = ROWS + 1;
+
+uint64_t getPositionKey(char b[ROWS][COLS]) {
+    uint64_t oBits = 0, mask = 0, bottom = 0;
+    for (int c = 0; c < COLS; c++) {
+        bottom |= 1ULL << (c * COL_BITS);
+        for (int r = ROWS - 1; r >= 0; r--) {
+            if (b[r][c] == ' ') break; // Gravity: nothing can sit above an empty cell
+            uint64_t bit = 1ULL << (c * COL_BITS + (ROWS - 1 - r));
+            mask |= bit;
+            if (b[r][c] == 'O') oBits |= bit;
+        }
+    }
+    return oBits + mask + bottom;
+}
+
+// --- BITBOARDS ---
+// Same layout as the position key: bit (col * COL_BITS + height), height 0 = bottom row.
+
+struct BitPosition {
+    uint64_t o = 0;
+    uint64_t x = 0;
+    uint64_t mask = 0;
+};
+
+constexpr uint64_t bottomMask(int col) {
+    return col < 0 ? 0 : bottomMask(col - 1) | (1ULL << (col * COL_BITS));
+}
+const uint64_t BOTTOM_MASK = bottomMask(COLS - 1);
+const uint64_t BOARD_MASK = BOTTOM_MASK * ((1ULL << ROWS) - 1);
+
+uint64_t columnMask(int col) {
+    return ((1ULL << ROWS) - 1) << (col * COL_BITS);
+}
+
+BitPosition toBitPosition(char b[ROWS][COLS]) {
+    BitPosition p;
+    for (int c = 0; c < COLS; c++) {
+        for (int r = ROWS - 1; r >= 0; r--) {
+            if (b[r][c] == ' ') break;
+            uint64_t bit = 1ULL << (c * COL_BITS + (ROWS - 1 - r));
+            p.mask |= bit;
+            if (b[r][c] == 'O') p.o |= bit; else p.x |= bit;
+        }
+    }
+    return p;
+}
+
+int popcount64(uint64_t v) {
+    #ifdef __GNUC__
+        return __builtin_popcountll(v); // A single instruction inside POPCNT kernel variants
+    #else
+        int n = 0;
+        while (v) { v &= v - 1; n++; }
+        return n;
+    #endif
+}
+
+// Lowest empty cell of every column that is not full.
+uint64_t playableCells(uint64_t mask) {
+    return (mask + BOTTOM_MASK) & BOARD_MASK;
+}
+
+// Empty cells (floating or not) that would complete four in a row for 'pieces'.
+HOT_KERNEL uint64_t winningCells(uint64_t pieces, uint64_t mask) {
+    // Vertical
+    uint64_t r = (pieces << 1) & (pieces << 2) & (pieces << 3);
+
+    // Horizontal, then both diagonals: for each direction, the missing cell can be
+    // at either end or in one of the two inner gaps.
+    const int steps[3] = {COL_BITS, COL_BITS - 1, COL_BITS + 1};
+    for (int s : steps) {
+        uint64_t p = (pieces << s) & (pieces << 2 * s);
+        r |= p & (pieces << 3 * s);
+        r |= p & (pieces >> s);
+        p = (pieces >> s) & (pieces >> 2 * s);
+        r |= p & (pieces << s);
+        r |= p & (pieces >> 3 * s);
+    }
+    return r & (BOARD_MASK ^ mask);
 }
 
 void showRules() {
@@ -94,26 +618,117 @@ void showRules() {
     cin.get(); 
 }
 
-void printBoard(int p1Score, int p2Score, string modeName) {
-    cout << CLEAR_SCREEN;
-    cout << "\n=== " << modeName << " ===\n";
-    cout << "  " << RED << "P1: " << p1Score << RESET;
-    cout << "      " << BLUE << "P2 (AI): " << p2Score << RESET << "\n";
-    cout << "  1    2    3    4    5    6    7\n";
-    cout << "┌────┬────┬────┬────┬────┬────┬────┐\n";
+// --- FRAME RENDERER ---
+// A whole frame is composed into one preallocated buffer and written with a
+// single system call. In diff mode, frames after the first only rewrite the
+// cells (and score line) that changed, using cursor-addressed ANSI updates.
+
+const int BOARD_FIRST_LINE = 5; // Screen line of the top border
+const int CELL_WIDTH = 5;       // " ██ │"
+
+void writeToTerminal(const string& bytes) {
+    cout.flush(); // Anything already queued on cout must come first
+    #ifdef _WIN32
+        fwrite(bytes.data(), 1, bytes.size(), stdout);
+        fflush(stdout);
+    #else
+        size_t done = 0;
+        while (done < bytes.size()) {
+            ssize_t n = write(STDOUT_FILENO, bytes.data() + done, bytes.size() - done);
+            if (n <= 0) break;
+            done += (size_t)n;
+        }
+    #endif
+}
+
+void appendCell(string& out, char cell) {
+    if (cell == 'X') { out += ' '; out += RED; out += "██"; out += RESET; out += ' '; }
+    else if (cell == 'O') { out += ' '; out += BLUE; out += "██"; out += RESET; out += ' '; }
+    else out += "    ";
+}
+
+void appendScoreLine(string& out, int p1Score, int p2Score) {
+    out += "  "; out += RED; out += "P1: "; out += to_string(p1Score); out += RESET;
+    out += "      "; out += BLUE; out += "P2 (AI): "; out += to_string(p2Score); out += RESET;
+}
+
+void appendCursor(string& out, int line, int column) {
+    out += "\033["; out += to_string(line); out += ';'; out += to_string(column); out += 'H';
+}
+
+// SIGWINCH: the terminal reflowed whatever was on it, so the next frame is drawn in full
+atomic<bool> terminalResized(false);
 
-    for (int i = 0; i < ROWS; i++) {
-        cout << "│"; 
-        for (int j = 0; j < COLS; j++) {
-            char cell = board[i][j];
-            if (cell == 'X') cout << " " << RED << "██" << RESET << " │";
-            else if (cell == 'O') cout << " " << BLUE << "██" << RESET << " │";
-            else cout << "    │";
+void onTerminalResize(int) {
+    terminalResized = true;
+}
+
+struct FrameRenderer {
+    string frame;
+    bool diffMode = false;
+    bool hasPrevious = false;
+    char previous[ROWS][COLS];
+    int previousP1 = 0, previousP2 = 0;
+    string previousMode;
+
+    FrameRenderer() { frame.reserve(4096); }
+
+    // Forget the screen contents (another screen was drawn in between)
+    void invalidate() { hasPrevious = false; }
+
+    void render(char b[ROWS][COLS], int p1Score, int p2Score, const string& modeName) {
+        if (terminalResized.exchange(false)) invalidate();
+        frame.clear();
+        if (diffMode && hasPrevious && modeName == previousMode) composeChanges(b, p1Score, p2Score);
+        else composeFull(b, p1Score, p2Score, modeName);
+
+        // Leave the cursor under the board and clear old prompts
+        appendCursor(frame, BOARD_FIRST_LINE + 2 * ROWS + 1, 1);
+        frame += "\033[J";
+        writeToTerminal(frame);
+
+        for (int i = 0; i < ROWS; i++) for (int j = 0; j < COLS; j++) previous[i][j] = b[i][j];
+        previousP1 = p1Score;
+        previousP2 = p2Score;
+        previousMode = modeName;
+        hasPrevious = true;
+    }
+
+    void composeFull(char b[ROWS][COLS], int p1Score, int p2Score, const string& modeName) {
+        frame += CLEAR_SCREEN;
+        frame += "\n=== "; frame += modeName; frame += " ===\n";
+        appendScoreLine(frame, p1Score, p2Score);
+        frame += "\n  1    2    3    4    5    6    7\n";
+        frame += "┌────┬────┬────┬────┬────┬────┬────┐\n";
+        for (int i = 0; i < ROWS; i++) {
+            frame += "│";
+            for (int j = 0; j < COLS; j++) { appendCell(frame, b[i][j]); frame += "│"; }
+            frame += "\n";
+            if (i < ROWS - 1) frame += "├────┼────┼────┼────┼────┼────┼────┤\n";
+            else frame += "└────┴────┴────┴────┴────┴────┴────┘\n";
+        }
+    }
+
+    void composeChanges(char b[ROWS][COLS], int p1Score, int p2Score) {
+        if (p1Score != previousP1 || p2Score != previousP2) {
+            appendCursor(frame, 3, 1);
+            frame += "\033[2K";
+            appendScoreLine(frame, p1Score, p2Score);
+        }
+        for (int i = 0; i < ROWS; i++) {
+            for (int j = 0; j < COLS; j++) {
+                if (b[i][j] == previous[i][j]) continue;
+                appendCursor(frame, BOARD_FIRST_LINE + 1 + 2 * i, 2 + CELL_WIDTH * j);
+                appendCell(frame, b[i][j]);
+            }
         }
-        cout << "\n"; 
-        if (i < ROWS - 1) cout << "├────┼────┼────┼────┼────┼────┼────┤\n";
-        else cout << "└────┴────┴────┴────┴────┴────┴────┘\n";
     }
+};
+
+FrameRenderer renderer;
+
+void printBoard(int p1Score, int p2Score, string modeName) {
+    renderer.render(board, p1Score, p2Score, modeName);
 }
 
 // --- CORE MECHANICS ---
@@ -125,7 +740,7 @@ int getNextOpenRow(char b[ROWS][COLS], int col) {
     return -1;
 }
 
-bool checkWin(char b[ROWS][COLS], char p) {
+HOT_KERNEL bool checkWin(char b[ROWS][COLS], char p) {
     for (int r=0; r<ROWS; r++) 
         for (int c=0; c<COLS-3; c++)
             if (b[r][c]==p && b[r][c+1]==p && b[r][c+2]==p && b[r][c+3]==p) return true;
@@ -191,7 +806,8 @@ int evaluateWindow(char c1, char c2, char c3, char c4, char piece) {
     return score;
 }
 
-int evaluateBoard(char b[ROWS][COLS], char piece) {
+HOT_KERNEL int evaluateBoard(char b[ROWS][COLS], char piece) {
+    searchStats.evalCalls++;
     int score = 0;
      
     // Center Control
@@ -218,6 +834,414 @@ int evaluateBoard(char b[ROWS][COLS], char piece) {
     return score;
 }
 
+// --- BATCH EVALUATION ---
+// evaluateBoard on bitboards, for scoring many independent positions (training
+// labels, leaf evaluation). Each window's score depends only on its counts
+// (3 pieces + 1 empty can never be open at both ends), so a direction is a few
+// shifted ANDs per category and a popcount. The AVX2 kernel runs the same ops
+// on 4 positions per instruction: bitboards need 64-bit lanes.
+// Weights must match evaluateWindow and the center bonus of evaluateBoard.
+
+// Cells where a window of this direction can start with all four cells on the board
+constexpr uint64_t windowStarts(int dc, int dh) {
+    uint64_t m = 0;
+    for (int c = 0; c + 3 * dc < COLS; c++)
+        for (int h = 0; h < ROWS; h++)
+            if (h + 3 * dh >= 0 && h + 3 * dh < ROWS) m |= 1ULL << (c * COL_BITS + h);
+    return m;
+}
+
+struct WindowDirection {
+    int shift;
+    uint64_t starts;
+};
+
+const WindowDirection WINDOW_DIRECTIONS[4] = {
+    {1, windowStarts(0, 1)},                // Vertical
+    {COL_BITS, windowStarts(1, 0)},         // Horizontal
+    {COL_BITS + 1, windowStarts(1, 1)},     // Diagonal up-right
+    {COL_BITS - 1, windowStarts(1, -1)},    // Diagonal down-right
+};
+
+const uint64_t CENTER_COLUMN = ((1ULL << ROWS) - 1) << (COLS / 2 * COL_BITS);
+const int BESIDE_CENTER_SHIFT = (COLS / 2 - 1) * COL_BITS; // Brings column 2 (and, doubled, column 4) to column 0
+
+// Same value as evaluateBoard(b, piece) for own = piece's stones, opp = the other side's
+HOT_KERNEL int evaluateBits(uint64_t own, uint64_t opp) {
+    uint64_t empty = BOARD_MASK & ~(own | opp);
+    uint64_t beside = ((own >> BESIDE_CENTER_SHIFT) | (own >> (COLS / 2 + 1) * COL_BITS)) & columnMask(0);
+    int score = 200 * popcount64(own & CENTER_COLUMN) + 100 * popcount64(beside);
+
+    for (const WindowDirection& d : WINDOW_DIRECTIONS) {
+        int s = d.shift;
+        uint64_t p0 = own, p1 = own >> s, p2 = own >> 2 * s, p3 = own >> 3 * s;
+        uint64_t q0 = opp, q1 = opp >> s, q2 = opp >> 2 * s, q3 = opp >> 3 * s;
+        uint64_t e0 = empty, e1 = empty >> s, e2 = empty >> 2 * s, e3 = empty >> 3 * s;
+
+        uint64_t four = p0 & p1 & p2 & p3;
+        uint64_t three = (e0 & p1 & p2 & p3) | (p0 & e1 & p2 & p3) | (p0 & p1 & e2 & p3) | (p0 & p1 & p2 & e3);
+        uint64_t connected = (p0 & p1 & e2 & e3) | (e0 & p1 & p2 & e3) | (e0 & e1 & p2 & p3);
+        uint64_t split = (p0 & e1 & p2 & e3) | (e0 & p1 & e2 & p3) | (p0 & e1 & e2 & p3);
+        uint64_t oppThree = (e0 & q1 & q2 & q3) | (q0 & e1 & q2 & q3) | (q0 & q1 & e2 & q3) | (q0 & q1 & q2 & e3);
+        uint64_t oppPair = (q0 & q1 & e2 & e3) | (e0 & q1 & q2 & e3) | (e0 & e1 & q2 & q3)
+                         | (q0 & e1 & q2 & e3) | (e0 & q1 & e2 & q3) | (q0 & e1 & e2 & q3);
+
+        score += FOUR_SCORE * popcount64(four & d.starts) + 150 * popcount64(three & d.starts)
+               + 50 * popcount64(connected & d.starts) + 60 * popcount64(split & d.starts)
+               - 500 * popcount64(oppThree & d.starts) - 50 * popcount64(oppPair & d.starts);
+    }
+    return score;
+}
+
+#ifdef HAS_AVX2_BATCH
+// Set bits per byte (nibble lookup), ready to be summed per lane with SAD
+__attribute__((target("avx2"))) inline __m256i byteCounts(__m256i v) {
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low = _mm256_set1_epi8(0x0F);
+    __m256i lo = _mm256_shuffle_epi8(lookup, _mm256_and_si256(v, low));
+    __m256i hi = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi64(v, 4), low));
+    return _mm256_add_epi8(lo, hi);
+}
+
+// Per-lane count (from summed byte counts) times a weight
+__attribute__((target("avx2"))) inline __m256i weighted(__m256i counts, int weight) {
+    return _mm256_mul_epu32(_mm256_sad_epu8(counts, _mm256_setzero_si256()), _mm256_set1_epi64x(weight));
+}
+
+__attribute__((target("avx2"))) void evaluateBatchAVX2(const uint64_t* own, const uint64_t* opp, size_t count, int32_t* scores) {
+    const __m256i board = _mm256_set1_epi64x((long long)BOARD_MASK);
+    const __m256i center = _mm256_set1_epi64x((long long)CENTER_COLUMN);
+    const __m256i firstColumn = _mm256_set1_epi64x((long long)columnMask(0));
+    const __m256i toLow32 = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256i p0 = _mm256_loadu_si256((const __m256i*)(own + i));
+        __m256i q0 = _mm256_loadu_si256((const __m256i*)(opp + i));
+        __m256i e0 = _mm256_andnot_si256(_mm256_or_si256(p0, q0), board);
+
+        // Byte counts of each category summed over the four directions (at most 32 per byte)
+        __m256i four = _mm256_setzero_si256(), three = four, connected = four, split = four, oppThree = four, oppPair = four;
+        for (const WindowDirection& d : WINDOW_DIRECTIONS) {
+            __m128i s1 = _mm_cvtsi32_si128(d.shift), s2 = _mm_cvtsi32_si128(2 * d.shift), s3 = _mm_cvtsi32_si128(3 * d.shift);
+            __m256i starts = _mm256_set1_epi64x((long long)d.starts);
+            __m256i p1 = _mm256_srl_epi64(p0, s1), p2 = _mm256_srl_epi64(p0, s2), p3 = _mm256_srl_epi64(p0, s3);
+            __m256i q1 = _mm256_srl_epi64(q0, s1), q2 = _mm256_srl_epi64(q0, s2), q3 = _mm256_srl_epi64(q0, s3);
+            __m256i e1 = _mm256_srl_epi64(e0, s1), e2 = _mm256_srl_epi64(e0, s2), e3 = _mm256_srl_epi64(e0, s3);
+            #define AND4(a, b, c, d) _mm256_and_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, d))
+            #define OR3(a, b, c) _mm256_or_si256(_mm256_or_si256(a, b), c)
+            __m256i f = AND4(p0, p1, p2, p3);
+            __m256i t = _mm256_or_si256(OR3(AND4(e0, p1, p2, p3), AND4(p0, e1, p2, p3), AND4(p0, p1, e2, p3)), AND4(p0, p1, p2, e3));
+            __m256i c = OR3(AND4(p0, p1, e2, e3), AND4(e0, p1, p2, e3), AND4(e0, e1, p2, p3));
+            __m256i sp = OR3(AND4(p0, e1, p2, e3), AND4(e0, p1, e2, p3), AND4(p0, e1, e2, p3));
+            __m256i ot = _mm256_or_si256(OR3(AND4(e0, q1, q2, q3), AND4(q0, e1, q2, q3), AND4(q0, q1, e2, q3)), AND4(q0, q1, q2, e3));
+            __m256i op = _mm256_or_si256(OR3(AND4(q0, q1, e2, e3), AND4(e0, q1, q2, e3), AND4(e0, e1, q2, q3)),
+                                         OR3(AND4(q0, e1, q2, e3), AND4(e0, q1, e2, q3), AND4(q0, e1, e2, q3)));
+            #undef AND4
+            #undef OR3
+            four = _mm256_add_epi8(four, byteCounts(_mm256_and_si256(f, starts)));
+            three = _mm256_add_epi8(three, byteCounts(_mm256_and_si256(t, starts)));
+            connected = _mm256_add_epi8(connected, byteCounts(_mm256_and_si256(c, starts)));
+            split = _mm256_add_epi8(split, byteCounts(_mm256_and_si256(sp, starts)));
+            oppThree = _mm256_add_epi8(oppThree, byteCounts(_mm256_and_si256(ot, starts)));
+            oppPair = _mm256_add_epi8(oppPair, byteCounts(_mm256_and_si256(op, starts)));
+        }
+        __m256i beside = _mm256_and_si256(_mm256_or_si256(_mm256_srli_epi64(p0, BESIDE_CENTER_SHIFT),
+                                                          _mm256_srli_epi64(p0, (COLS / 2 + 1) * COL_BITS)), firstColumn);
+        __m256i plus = _mm256_add_epi64(_mm256_add_epi64(weighted(four, FOUR_SCORE), weighted(three, 150)),
+                                        _mm256_add_epi64(weighted(connected, 50), weighted(split, 60)));
+        plus = _mm256_add_epi64(plus, _mm256_add_epi64(weighted(byteCounts(_mm256_and_si256(p0, center)), 200),
+                                                       weighted(byteCounts(beside), 100)));
+        __m256i minus = _mm256_add_epi64(weighted(oppThree, 500), weighted(oppPair, 50));
+        __m256i result = _mm256_permutevar8x32_epi32(_mm256_sub_epi64(plus, minus), toLow32);
+        _mm_storeu_si128((__m128i*)(scores + i), _mm256_castsi256_si128(result));
+    }
+    for (; i < count; i++) scores[i] = evaluateBits(own[i], opp[i]);
+}
+#endif
+
+bool batchUsesAVX2() {
+    #ifdef HAS_AVX2_BATCH
+        static const bool supported = __builtin_cpu_supports("avx2");
+        return supported;
+    #else
+        return false;
+    #endif
+}
+
+// Positions laid out struct-of-arrays: own[i] / opp[i] are position i's bitboards
+// from the evaluated side's point of view. scores[i] = evaluateBits(own[i], opp[i]).
+void evaluateBatch(const uint64_t* own, const uint64_t* opp, size_t count, int32_t* scores) {
+    #ifdef HAS_AVX2_BATCH
+        if (batchUsesAVX2()) { evaluateBatchAVX2(own, opp, count, scores); return; }
+    #endif
+    for (size_t i = 0; i < count; i++) scores[i] = evaluateBits(own[i], opp[i]);
+}
+
+// --- PLAYOUT KERNEL ---
+// Random playouts (uniform legal moves to the end of the game) for rollout
+// estimates. Game g draws its moves from its own xorshift stream seeded by
+// (seed, g), so results do not depend on which lane played it: the AVX2
+// kernel keeps 16 games in flight (four vectors of 4), and a lane whose game
+// ends writes its result and takes the next game. Classic playouts stop at
+// the first four; Score Attack playouts fill the board and compare lines.
+
+struct PlayoutResult {
+    char winner;            // 'X', 'O', or ' ' for a draw
+    uint8_t plies;          // Moves played from the start position
+    uint8_t xLines, oLines; // Four-in-a-row windows at the end (countLines)
+};
+
+uint64_t playoutSeed(uint64_t seed, uint64_t game) {
+    return slotIndex(seed + game * 0x9E3779B97F4A7C15ULL) | 1; // xorshift state must not be 0
+}
+
+uint64_t xorshiftNext(uint64_t& x) {
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return x;
+}
+
+// Every window of four owned by 'pieces'; the empty top bit of each column keeps shifts inside a line
+int countLinesBits(uint64_t pieces) {
+    int lines = 0;
+    for (const WindowDirection& d : WINDOW_DIRECTIONS) {
+        uint64_t m = pieces & (pieces >> d.shift);
+        lines += popcount64(m & (m >> 2 * d.shift));
+    }
+    return lines;
+}
+
+bool hasFour(uint64_t pieces) {
+    for (const WindowDirection& d : WINDOW_DIRECTIONS) {
+        uint64_t m = pieces & (pieces >> d.shift);
+        if (m & (m >> 2 * d.shift)) return true;
+    }
+    return false;
+}
+
+// Uniform random playable column: draw one of the 7 and redraw while it is full
+int playoutColumn(uint64_t playable, uint64_t& rng) {
+    while (true) {
+        int c = (int)(((xorshiftNext(rng) >> 32) * COLS) >> 32);
+        if (playable & columnMask(c)) return c;
+    }
+}
+
+// Outcome once the game has ended with 'x' and 'o' on the board
+PlayoutResult finishPlayout(uint64_t x, uint64_t o, int plies, bool won, char lastMover, bool scoreAttack) {
+    PlayoutResult r;
+    r.plies = (uint8_t)plies;
+    r.xLines = (uint8_t)countLinesBits(x);
+    r.oLines = (uint8_t)countLinesBits(o);
+    if (scoreAttack) r.winner = r.xLines > r.oLines ? 'X' : (r.oLines > r.xLines ? 'O' : ' ');
+    else r.winner = won ? lastMover : ' ';
+    return r;
+}
+
+// One game from 'start' with 'toMove' to play; the start must be unfinished
+PlayoutResult playoutScalar(const BitPosition& start, char toMove, bool scoreAttack, uint64_t rng) {
+    uint64_t mover = toMove == 'O' ? start.o : start.x;
+    uint64_t other = start.mask ^ mover;
+    uint64_t mask = start.mask;
+    int plies = 0;
+    bool won = false;
+    while (mask != BOARD_MASK) {
+        uint64_t playable = playableCells(mask);
+        uint64_t cell = playable & columnMask(playoutColumn(playable, rng));
+        mover |= cell;
+        mask |= cell;
+        plies++;
+        if (!scoreAttack && hasFour(mover)) { won = true; break; }
+        swap(mover, other);
+    }
+    bool startSideMovedLast = (plies % 2 == 1);
+    char lastMover = startSideMovedLast ? toMove : (toMove == 'X' ? 'O' : 'X');
+    // 'mover' holds the last mover's stones if the game was won, otherwise the side after it
+    uint64_t lastStones = won ? mover : other;
+    uint64_t x = lastMover == 'X' ? lastStones : mask ^ lastStones;
+    return finishPlayout(x, mask ^ x, plies, won, lastMover, scoreAttack);
+}
+
+#ifdef HAS_AVX2_BATCH
+const int PLAYOUT_VECTORS = 4; // Independent dependency chains per step (2 and 8 measured slower)
+const int PLAYOUT_LANES = 4 * PLAYOUT_VECTORS;
+
+__attribute__((target("avx2"))) void playoutsAVX2(const BitPosition& start, char toMove, bool scoreAttack,
+                                                  uint64_t seed, size_t games, PlayoutResult* results) {
+    alignas(32) uint64_t mover[PLAYOUT_LANES], other[PLAYOUT_LANES], mask[PLAYOUT_LANES], rng[PLAYOUT_LANES];
+    size_t game[PLAYOUT_LANES];
+    int plies[PLAYOUT_LANES];
+    uint64_t startMover = toMove == 'O' ? start.o : start.x;
+    size_t next = 0;
+    unsigned busy = 0; // Lanes with a game; idle lanes sit on a full board, which has no move
+
+    auto load = [&](int lane) {
+        plies[lane] = 0;
+        if (next == games) {
+            mover[lane] = other[lane] = 0;
+            mask[lane] = BOARD_MASK;
+            busy &= ~(1u << lane);
+            return;
+        }
+        game[lane] = next;
+        rng[lane] = playoutSeed(seed, next++);
+        mover[lane] = startMover;
+        other[lane] = start.mask ^ startMover;
+        mask[lane] = start.mask;
+        busy |= 1u << lane;
+    };
+    for (int lane = 0; lane < PLAYOUT_LANES; lane++) load(lane);
+
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i ones = _mm256_set1_epi64x(-1);
+    const __m256i bottom = _mm256_set1_epi64x((long long)BOTTOM_MASK);
+    const __m256i board = _mm256_set1_epi64x((long long)BOARD_MASK);
+    const __m256i sevens = _mm256_set1_epi64x(COLS);
+    const __m256i firstColumn = _mm256_set1_epi64x((long long)columnMask(0));
+
+    while (busy) {
+        __m256i me[PLAYOUT_VECTORS], m[PLAYOUT_VECTORS], x[PLAYOUT_VECTORS];
+        __m256i playable[PLAYOUT_VECTORS], pending[PLAYOUT_VECTORS], cell[PLAYOUT_VECTORS];
+        for (int v = 0; v < PLAYOUT_VECTORS; v++) {
+            me[v] = _mm256_load_si256((const __m256i*)(mover + 4 * v));
+            m[v] = _mm256_load_si256((const __m256i*)(mask + 4 * v));
+            x[v] = _mm256_load_si256((const __m256i*)(rng + 4 * v));
+            playable[v] = _mm256_and_si256(_mm256_add_epi64(m[v], bottom), board);
+            pending[v] = _mm256_xor_si256(_mm256_cmpeq_epi64(playable[v], zero), ones);
+            cell[v] = zero;
+        }
+
+        // Column draws as in playoutColumn; only lanes that drew a full column draw again.
+        // All vectors draw together so their dependency chains overlap.
+        __m256i anyPending;
+        do {
+            anyPending = zero;
+            for (int v = 0; v < PLAYOUT_VECTORS; v++) {
+                __m256i drawn = _mm256_xor_si256(x[v], _mm256_slli_epi64(x[v], 13));
+                drawn = _mm256_xor_si256(drawn, _mm256_srli_epi64(drawn, 7));
+                drawn = _mm256_xor_si256(drawn, _mm256_slli_epi64(drawn, 17));
+                x[v] = _mm256_blendv_epi8(x[v], drawn, pending[v]);
+                __m256i col = _mm256_srli_epi64(_mm256_mul_epu32(_mm256_srli_epi64(drawn, 32), sevens), 32);
+                __m256i shift = _mm256_sub_epi64(_mm256_slli_epi64(col, 3), col); // col * COL_BITS
+                __m256i found = _mm256_and_si256(_mm256_and_si256(playable[v], _mm256_sllv_epi64(firstColumn, shift)), pending[v]);
+                cell[v] = _mm256_or_si256(cell[v], found);
+                pending[v] = _mm256_and_si256(pending[v], _mm256_cmpeq_epi64(found, zero));
+                anyPending = _mm256_or_si256(anyPending, pending[v]);
+            }
+        } while (!_mm256_testz_si256(anyPending, anyPending));
+
+        unsigned ended = 0;
+        for (int v = 0; v < PLAYOUT_VECTORS; v++) {
+            __m256i them = _mm256_load_si256((const __m256i*)(other + 4 * v));
+            __m256i p = _mm256_or_si256(me[v], cell[v]);
+            m[v] = _mm256_or_si256(m[v], cell[v]);
+            __m256i end = _mm256_cmpeq_epi64(m[v], board);
+            if (!scoreAttack) {
+                #define FOUR_IN_DIRECTION(s) _mm256_and_si256(_mm256_and_si256(p, _mm256_srli_epi64(p, s)), \
+                                                          _mm256_srli_epi64(_mm256_and_si256(p, _mm256_srli_epi64(p, s)), 2 * (s)))
+                __m256i four = _mm256_or_si256(_mm256_or_si256(FOUR_IN_DIRECTION(1), FOUR_IN_DIRECTION(COL_BITS)),
+                                               _mm256_or_si256(FOUR_IN_DIRECTION(COL_BITS - 1), FOUR_IN_DIRECTION(COL_BITS + 1)));
+                #undef FOUR_IN_DIRECTION
+                end = _mm256_or_si256(end, _mm256_xor_si256(_mm256_cmpeq_epi64(four, zero), ones));
+            }
+            // Swap sides, except in ended lanes, which keep the last mover in 'mover'
+            _mm256_store_si256((__m256i*)(mover + 4 * v), _mm256_blendv_epi8(them, p, end));
+            _mm256_store_si256((__m256i*)(other + 4 * v), _mm256_blendv_epi8(p, them, end));
+            _mm256_store_si256((__m256i*)(mask + 4 * v), m[v]);
+            _mm256_store_si256((__m256i*)(rng + 4 * v), x[v]);
+            ended |= (unsigned)_mm256_movemask_pd(_mm256_castsi256_pd(end)) << (4 * v);
+        }
+        for (int lane = 0; lane < PLAYOUT_LANES; lane++) plies[lane]++;
+
+        // Retire finished games and refill their lanes
+        ended &= busy;
+        while (ended) {
+            int lane = __builtin_ctz(ended);
+            ended &= ended - 1;
+            char lastMover = (plies[lane] % 2 == 1) ? toMove : (toMove == 'X' ? 'O' : 'X');
+            uint64_t x = lastMover == 'X' ? mover[lane] : mask[lane] ^ mover[lane];
+            bool won = !scoreAttack && hasFour(mover[lane]);
+            results[game[lane]] = finishPlayout(x, mask[lane] ^ x, plies[lane], won, lastMover, scoreAttack);
+            load(lane);
+        }
+    }
+}
+#endif
+
+// results[g] = playoutScalar(start, toMove, scoreAttack, playoutSeed(seed, g)) for every g < games
+void runPlayouts(const BitPosition& start, char toMove, bool scoreAttack, uint64_t seed, size_t games, PlayoutResult* results) {
+    #ifdef HAS_AVX2_BATCH
+        if (batchUsesAVX2()) { playoutsAVX2(start, toMove, scoreAttack, seed, games, results); return; }
+    #endif
+    for (size_t g = 0; g < games; g++) results[g] = playoutScalar(start, toMove, scoreAttack, playoutSeed(seed, g));
+}
+
+// --- EVALUATION CACHE ---
+// Static evaluations keyed by position, sized independently of the memo table.
+// Lock-free: each slot stores (key ^ data) next to data, so a slot torn by two
+// concurrent writers simply fails verification and counts as a miss.
+
+const int DEFAULT_EVAL_CACHE_MB = 4;
+
+struct EvalCacheEntry {
+    atomic<uint64_t> check{0};
+    atomic<uint64_t> data{0};
+};
+
+struct EvalCache {
+    vector<EvalCacheEntry> entries;
+    uint64_t indexMask = 0;
+
+    // Rounds down to a power of two; 0 MB disables the cache.
+    void resize(int megabytes) {
+        size_t count = 0;
+        size_t wanted = (size_t)megabytes * 1024 * 1024 / sizeof(EvalCacheEntry);
+        if (wanted > 0) { count = 1; while (count * 2 <= wanted) count *= 2; }
+        entries = vector<EvalCacheEntry>(count);
+        indexMask = count ? count - 1 : 0;
+    }
+
+    void clear() {
+        for (auto& e : entries) { e.check.store(0, memory_order_relaxed); e.data.store(0, memory_order_relaxed); }
+    }
+
+    bool enabled() const { return !entries.empty(); }
+
+    static uint64_t slotKey(uint64_t positionKey, char piece) {
+        return positionKey ^ (piece == 'X' ? (1ULL << 63) : 0); // Key uses 49 bits, so bit 63 is free
+    }
+
+    bool probe(uint64_t key, int& score) {
+        EvalCacheEntry& e = entries[slotIndex(key) & indexMask];
+        uint64_t data = e.data.load(memory_order_relaxed);
+        if ((e.check.load(memory_order_relaxed) ^ data) != key) return false;
+        score = (int)(int32_t)(uint32_t)data;
+        return true;
+    }
+
+    void store(uint64_t key, int score) {
+        EvalCacheEntry& e = entries[slotIndex(key) & indexMask];
+        uint64_t data = (uint32_t)score;
+        e.data.store(data, memory_order_relaxed);
+        e.check.store(key ^ data, memory_order_relaxed);
+    }
+};
+
+EvalCache evalCache;
+
+int cachedEvaluate(char b[ROWS][COLS], char piece) {
+    if (!evalCache.enabled()) return evaluateBoard(b, piece);
+    uint64_t key = EvalCache::slotKey(getPositionKey(b), piece);
+    int score;
+    searchStats.evalCacheProbes++;
+    if (evalCache.probe(key, score)) { searchStats.evalCacheHits++; return score; }
+    score = evaluateBoard(b, piece);
+    evalCache.store(key, score);
+    return score;
+}
+
 // --- AI UTILITIES ---
 
 int countThreats(char b[ROWS][COLS], char piece) {
@@ -234,7 +1258,7 @@ int countThreats(char b[ROWS][COLS], char piece) {
 }
 
 int evaluateMoveSimple(char b[ROWS][COLS], char piece) {
-    return evaluateBoard(b, piece);
+    return cachedEvaluate(b, piece);
 }
 
 vector<int> getOptimizedMoves(char b[ROWS][COLS], bool maximizingPlayer) {
@@ -281,114 +1305,2580 @@ int getAdaptiveDepth(char b[ROWS][COLS], int base_depth) {
 
 // --- MINIMAX ALGORITHM ---
 
-pair<int, int> minimax(char b[ROWS][COLS], int depth, int alpha, int beta, bool maximizingPlayer, bool isScoreAttack, int original_depth) {
-     
-    string key = getBoardHash(b) + to_string(depth) + (maximizingPlayer ? "T" : "F");
-    if (memo.find(key) != memo.end()) return memo[key];
+// Memo key: position (49 bits) and side (1)
+// Score Attack scores differ from Classic ones, so the rule set is part of the key
+uint64_t transpositionKey(char b[ROWS][COLS], bool maximizingPlayer, bool isScoreAttack = false) {
+    return getPositionKey(b) | (uint64_t)maximizingPlayer << 55 | (uint64_t)isScoreAttack << 56;
+}
 
-    if (!isScoreAttack) {
-        if (checkWin(b, 'O')) return {-1, 1000000 + depth}; 
-        if (checkWin(b, 'X')) return {-1, -1000000 - depth}; 
-    }
-     
-    int empty_cells = 0;
-    for (int i=0; i<ROWS; i++) for(int j=0; j<COLS; j++) if(b[i][j]==' ') empty_cells++;
-    if (empty_cells <= (original_depth * 2) && !isScoreAttack) depth = empty_cells;
+// Win scores count the remaining depth at the win. Stored relative to the node
+// (plies to the win), so an entry reused at another depth keeps its distance.
+const int WIN_SCORE_THRESHOLD = 900000;
 
-    if (depth == 0) {
-        return {-1, evaluateBoard(b, 'O')};
-    }
+int scoreToMemo(int score, int depth) {
+    if (score >= WIN_SCORE_THRESHOLD) return score - depth;
+    if (score <= -WIN_SCORE_THRESHOLD) return score + depth;
+    return score;
+}
 
-    vector<int> valid_locs = getOptimizedMoves(b, maximizingPlayer);
-    if (valid_locs.empty()) return {-1, 0};
+int scoreFromMemo(int score, int depth) {
+    if (score >= WIN_SCORE_THRESHOLD) return score + depth;
+    if (score <= -WIN_SCORE_THRESHOLD) return score - depth;
+    return score;
+}
 
-    int bestCol = valid_locs[0];
-    int bestScore = maximizingPlayer ? INT_MIN : INT_MAX;
+// Deeper results are reused only from earlier moves: within a move, exact
+// depths keep the root-parallel result identical to the serial search.
+bool usableDepth(const MemoEntry& e, int depth) {
+    return e.depth == depth || (e.depth > depth && e.generation != searchGeneration && !searchTuning.exactDepthOnly);
+}
+
+// Finds an entry searched to a usable depth (key from transpositionKey)
+bool probeMemo(uint64_t key, int depth, MemoEntry& out) {
+    searchStats.ttProbes++;
+    TTHit hit = activeMemo().find(key, depth, out);
+    if (hit == TT_MISS || !usableDepth(out, depth)) return false;
+    if (hit == TT_HOT) searchStats.ttHotHits++;
+    else searchStats.ttMainHits++;
+    return true;
+}
+
+MemoEntry memoEntry(int col, int score, MemoBound bound, int depth) {
+    MemoEntry e = {col, scoreToMemo(score, depth), bound};
+    e.depth = depth;
+    e.generation = searchGeneration;
+    return e;
+}
+
+void storeMemo(uint64_t key, const MemoEntry& entry) {
+    activeMemo().store(key, entry);
+}
+
+// Ordered move list for a minimax node. Returns true when the node is decided
+// without searching (no moves, immediate win, or every move loses) and fills 'result'.
+bool prepareSearchMoves(char b[ROWS][COLS], int depth, bool maximizingPlayer, bool isScoreAttack,
+                        vector<int>& moves, int& childDepth, pair<int, int>& result) {
+    moves = getOptimizedMoves(b, maximizingPlayer);
+    childDepth = depth - 1;
+    if (moves.empty()) { result = {-1, 0}; return true; }
+
+    // Threat analysis (classic only): win at once if possible, otherwise keep only
+    // moves that neither ignore an opponent threat nor play right under one.
+    // A single surviving move is a forced move and is searched without using up depth.
+    if (!isScoreAttack && searchTuning.nonLosingMoves) {
+        BitPosition pos = toBitPosition(b);
+        uint64_t own = maximizingPlayer ? pos.o : pos.x;
+        uint64_t opp = maximizingPlayer ? pos.x : pos.o;
+        uint64_t playable = playableCells(pos.mask);
+        uint64_t ownWins = playable & winningCells(own, pos.mask);
+        if (ownWins) {
+            int col = 0;
+            while (!(ownWins & columnMask(col))) col++;
+            result = {col, maximizingPlayer ? 1000000 + depth - 1 : -1000000 - (depth - 1)};
+            return true;
+        }
+
+        uint64_t oppWins = winningCells(opp, pos.mask);
+        uint64_t candidates = playable;
+        uint64_t forced = playable & oppWins;
+        if (forced) candidates = (forced & (forced - 1)) ? 0 : forced; // Two threats cannot both be blocked
+        candidates &= ~(oppWins >> 1);
+
+        if (!candidates) {
+            result = {moves[0], maximizingPlayer ? -1000000 - (depth - 2) : 1000000 + depth - 2};
+            return true;
+        }
+
+        vector<int> nonLosing;
+        for (int col : moves) if (candidates & columnMask(col)) nonLosing.push_back(col);
+        moves.swap(nonLosing);
+        if (moves.size() == 1) childDepth = depth; // Forced-move extension
+    }
+    return false;
+}
+
+pair<int, int> minimax(char b[ROWS][COLS], int depth, int alpha, int beta, bool maximizingPlayer, bool isScoreAttack, int original_depth) {
+     
+    searchStats.nodes++;
+    if (searchAborted) return {-1, 0};
+    if (searchLimits.nodeLimit) {
+        uint64_t counted = searchLimits.nodeCounter ? searchLimits.nodeCounter->fetch_add(1, memory_order_relaxed) + 1
+                                                    : searchStats.nodes;
+        if (counted > searchLimits.nodeLimit) {
+            searchAborted = true;
+            return {-1, 0};
+        }
+    }
+    if ((searchStats.nodes & 1023) == 0) {
+        bool stopped = searchLimits.stop && searchLimits.stop->load(memory_order_relaxed);
+        bool expired = searchLimits.hasDeadline && chrono::steady_clock::now() >= searchLimits.deadline;
+        if (stopped || expired) {
+            searchAborted = true;
+            return {-1, 0};
+        }
+    }
+    if (!isScoreAttack) {
+        if (checkWin(b, 'O')) return {-1, 1000000 + depth}; 
+        if (checkWin(b, 'X')) return {-1, -1000000 - depth}; 
+    }
+     
+    int empty_cells = 0;
+    for (int i=0; i<ROWS; i++) for(int j=0; j<COLS; j++) if(b[i][j]==' ') empty_cells++;
+    if (empty_cells <= (original_depth * 2) && !isScoreAttack) depth = empty_cells;
+
+    uint64_t key = transpositionKey(b, maximizingPlayer, isScoreAttack);
+    if (deterministicMode) {
+        searchStats.traceHash = fnv1a(searchStats.traceHash, key);
+        searchStats.traceHash = fnv1a(searchStats.traceHash, (uint64_t)depth);
+    }
+    // Noisy levels key their entries by the move's noise as well, so entries scored
+    // under an earlier move's noise just miss and age out; nothing is cleared per move
+    if (searchTuning.evalNoise > 0) key ^= (searchTuning.noiseSeed | 1) * 0x9E3779B97F4A7C15ULL;
+    if (searchTuning.sideToMoveLeaves) key ^= 0xD6E8FEB86659FD93ULL; // Other leaf scores, other entries
+    // Entries keep only 21 check bits, so a false hit can carry another position's
+    // column; one that isn't playable here must never reach the caller as a move
+    MemoEntry cached;
+    if (probeMemo(key, depth, cached) && cached.col >= 0 && getNextOpenRow(b, cached.col) != -1) {
+        int score = scoreFromMemo(cached.score, depth);
+        if (cached.bound == BOUND_EXACT ||
+            (cached.bound == BOUND_LOWER && score >= beta) ||
+            (cached.bound == BOUND_UPPER && score <= alpha)) {
+            return {cached.col, score};
+        }
+    }
+    int alphaOrig = alpha, betaOrig = beta;
+
+    if (depth == 0) {
+        int score = searchTuning.sideToMoveLeaves && !maximizingPlayer ? -cachedEvaluate(b, 'X') : cachedEvaluate(b, 'O');
+        if (searchTuning.evalNoise > 0) {
+            // Hash-based, so a position keeps the same noise for the whole search
+            uint64_t h = (getPositionKey(b) ^ searchTuning.noiseSeed) * 0x9E3779B97F4A7C15ULL;
+            score += (int)((h >> 32) % (uint64_t)(2 * searchTuning.evalNoise + 1)) - searchTuning.evalNoise;
+        }
+        return {-1, score};
+    }
+
+    vector<int> valid_locs;
+    int childDepth;
+    pair<int, int> decided;
+    if (prepareSearchMoves(b, depth, maximizingPlayer, isScoreAttack, valid_locs, childDepth, decided)) return decided;
+
+    int bestCol = valid_locs[0];
+    int bestScore = maximizingPlayer ? INT_MIN : INT_MAX;
+
+    // Heuristic search (not the exact endgame solve below the depth override)
+    bool heuristic = isScoreAttack || empty_cells > original_depth * 2;
+
+    // Futility: if the static eval is hopeless even with a margin, only the
+    // best-ordered move and immediate wins are searched near the horizon.
+    bool futile = false;
+    if (heuristic && searchTuning.futilityPruning && depth <= 2) {
+        int staticEval = cachedEvaluate(b, 'O');
+        int margin = searchTuning.futilityMargin * depth;
+        futile = maximizingPlayer ? (staticEval + margin <= alpha) : (staticEval - margin >= beta);
+    }
+    bool pruned = false; // A skipped move could still beat bestScore, so it is only a bound
 
     if (maximizingPlayer) {
-        for (int col : valid_locs) {
+        for (int i = 0; i < (int)valid_locs.size(); i++) {
+            int col = valid_locs[i];
             int row = getNextOpenRow(b, col);
             b[row][col] = 'O';
-            int score = minimax(b, depth - 1, alpha, beta, false, isScoreAttack, original_depth).second;
+            if (futile && i > 0 && !checkWin(b, 'O')) { b[row][col] = ' '; pruned = true; continue; }
+
+            int score;
+            if (heuristic && searchTuning.lateMoveReductions && i >= searchTuning.lmrFullDepthMoves && depth >= searchTuning.lmrMinDepth && depth < original_depth) {
+                int reduced = max(0, childDepth - searchTuning.lmrReduction);
+                score = minimax(b, reduced, alpha, beta, false, isScoreAttack, original_depth).second;
+                // Verification: a reduced move that looks better than alpha gets the full depth
+                if (score > alpha) score = minimax(b, childDepth, alpha, beta, false, isScoreAttack, original_depth).second;
+            } else {
+                score = minimax(b, childDepth, alpha, beta, false, isScoreAttack, original_depth).second;
+            }
             b[row][col] = ' '; 
             
             if (score > bestScore) {
                 bestScore = score;
                 bestCol = col;
-                if (depth == original_depth && score > 900000) {
-                    memo[key] = {bestCol, bestScore};
+                if (depth == original_depth && score > 900000 && !searchAborted) {
+                    storeMemo(key, memoEntry(bestCol, bestScore, BOUND_LOWER, depth)); // Remaining moves were not searched
                     return {bestCol, bestScore};
                 }
             }
             alpha = max(alpha, bestScore);
             if (alpha >= beta) break; 
         }
-    } 
-    else {
-        for (int col : valid_locs) {
-            int row = getNextOpenRow(b, col);
-            b[row][col] = 'X';
-            int score = minimax(b, depth - 1, alpha, beta, true, isScoreAttack, original_depth).second;
-            b[row][col] = ' '; 
-            
-            if (score < bestScore) {
-                bestScore = score;
-                bestCol = col;
-            }
-            beta = min(beta, bestScore);
-            if (beta <= alpha) break; 
+    } 
+    else {
+        for (int i = 0; i < (int)valid_locs.size(); i++) {
+            int col = valid_locs[i];
+            int row = getNextOpenRow(b, col);
+            b[row][col] = 'X';
+            if (futile && i > 0 && !checkWin(b, 'X')) { b[row][col] = ' '; pruned = true; continue; }
+
+            int score;
+            if (heuristic && searchTuning.lateMoveReductions && i >= searchTuning.lmrFullDepthMoves && depth >= searchTuning.lmrMinDepth && depth < original_depth) {
+                int reduced = max(0, childDepth - searchTuning.lmrReduction);
+                score = minimax(b, reduced, alpha, beta, true, isScoreAttack, original_depth).second;
+                if (score < beta) score = minimax(b, childDepth, alpha, beta, true, isScoreAttack, original_depth).second;
+            } else {
+                score = minimax(b, childDepth, alpha, beta, true, isScoreAttack, original_depth).second;
+            }
+            b[row][col] = ' '; 
+            
+            if (score < bestScore) {
+                bestScore = score;
+                bestCol = col;
+            }
+            beta = min(beta, bestScore);
+            if (beta <= alpha) break; 
+        }
+    }
+
+    if (searchAborted) return {bestCol, bestScore};
+    MemoBound bound = BOUND_EXACT;
+    if (pruned) bound = maximizingPlayer ? BOUND_LOWER : BOUND_UPPER;
+    else if (bestScore <= alphaOrig) bound = BOUND_UPPER;
+    else if (bestScore >= betaOrig) bound = BOUND_LOWER;
+    storeMemo(key, memoEntry(bestCol, bestScore, bound, depth));
+
+    return {bestCol, bestScore};
+}
+
+// --- ROOT-PARALLEL SEARCH ---
+// Root moves are handed out to threads one at a time. Each thread searches on its
+// own board copy with the best root score so far as its bound (a shared atomic),
+// and all threads share one lock-free transposition table. Scores beyond the bound a move was
+// searched with are exact and only those compete, so the root value is the same as the
+// serial search and the move played always has a proven score.
+
+thread_local int rootSearchThreads = 1;
+
+pair<int, int> parallelRootSearch(char b[ROWS][COLS], int depth, bool maximizingPlayer, bool isScoreAttack, int threads) {
+    int empty_cells = 0;
+    for (int i=0; i<ROWS; i++) for(int j=0; j<COLS; j++) if(b[i][j]==' ') empty_cells++;
+    int rootDepth = (empty_cells <= depth * 2 && !isScoreAttack) ? empty_cells : depth;
+    bool terminal = !isScoreAttack && (checkWin(b, 'O') || checkWin(b, 'X'));
+
+    vector<int> moves;
+    int childDepth;
+    pair<int, int> decided;
+    if (threads <= 1 || terminal || rootDepth == 0 ||
+        prepareSearchMoves(b, rootDepth, maximizingPlayer, isScoreAttack, moves, childDepth, decided) || moves.size() < 2) {
+        return minimax(b, depth, INT_MIN, INT_MAX, maximizingPlayer, isScoreAttack, depth);
+    }
+
+    // Workers share the calling thread's memo table
+    TranspositionTable* shared = &activeMemo();
+    atomic<int> bound(maximizingPlayer ? INT_MIN : INT_MAX);
+    atomic<int> nextMove(0);
+    mutex resultLock;
+    int bestIdx = -1, bestScore = 0;
+    bool aborted = false;
+    SearchStats total;
+
+    SearchTuning tuning = searchTuning;
+    // Workers count their own nodes from zero, so a node budget is spent from one
+    // counter that continues the caller's: the move costs the same on any core count
+    SearchLimits limits = searchLimits;
+    atomic<uint64_t> budgetNodes(searchStats.nodes + 1); // + the root itself
+    if (limits.nodeLimit) limits.nodeCounter = &budgetNodes;
+    char piece = maximizingPlayer ? 'O' : 'X';
+    uint8_t generation = searchGeneration;
+
+    auto worker = [&]() {
+        searchTuning = tuning;
+        searchGeneration = generation;
+        searchLimits = limits;
+        searchAborted = false;
+        searchStats = SearchStats();
+        sharedMemo = shared;
+
+        char copy[ROWS][COLS];
+        for (int i = 0; i < ROWS; i++) for (int j = 0; j < COLS; j++) copy[i][j] = b[i][j];
+
+        while (true) {
+            int i = nextMove.fetch_add(1);
+            if (i >= (int)moves.size()) break;
+            int col = moves[i];
+            int row = getNextOpenRow(copy, col);
+            copy[row][col] = piece;
+            int window = bound.load();
+            int score = maximizingPlayer
+                ? minimax(copy, childDepth, window, INT_MAX, false, isScoreAttack, depth).second
+                : minimax(copy, childDepth, INT_MIN, window, true, isScoreAttack, depth).second;
+            copy[row][col] = ' ';
+            if (searchAborted) break;
+
+            // A move that fails low at the bound only proves it is no better, so
+            // it may neither claim a tie nor stand in for a proven move
+            bool exact = maximizingPlayer ? score > window : score < window;
+            if (!exact) continue;
+
+            int current = bound.load();
+            while ((maximizingPlayer ? score > current : score < current) && !bound.compare_exchange_weak(current, score)) {}
+
+            lock_guard<mutex> guard(resultLock);
+            bool better = maximizingPlayer ? score > bestScore : score < bestScore;
+            if (bestIdx == -1 || better || (score == bestScore && i < bestIdx)) { bestIdx = i; bestScore = score; }
+        }
+
+        lock_guard<mutex> guard(resultLock);
+        total.nodes += searchStats.nodes;
+        total.evalCalls += searchStats.evalCalls;
+        total.evalCacheProbes += searchStats.evalCacheProbes;
+        total.evalCacheHits += searchStats.evalCacheHits;
+        total.ttProbes += searchStats.ttProbes;
+        total.ttHotHits += searchStats.ttHotHits;
+        total.ttMainHits += searchStats.ttMainHits;
+        aborted = aborted || searchAborted;
+        sharedMemo = nullptr;
+    };
+
+    vector<thread> pool;
+    for (int t = 0; t < threads; t++) pool.emplace_back(worker);
+    for (auto& t : pool) t.join();
+
+    searchStats.nodes += total.nodes + 1; // + the root itself
+    searchStats.evalCalls += total.evalCalls;
+    searchStats.evalCacheProbes += total.evalCacheProbes;
+    searchStats.evalCacheHits += total.evalCacheHits;
+    searchStats.ttProbes += total.ttProbes;
+    searchStats.ttHotHits += total.ttHotHits;
+    searchStats.ttMainHits += total.ttMainHits;
+    if (aborted) searchAborted = true;
+    if (bestIdx == -1) return {moves[0], 0};
+    return {moves[bestIdx], bestScore};
+}
+
+// --- EXACT SOLVER ---
+// Perfect-play value of a classic position, on bitboards only: negamax with
+// alpha-beta, non-losing move generation, threat-count move ordering and a
+// transposition table of bounds, narrowed with null-window searches.
+// Scores follow the usual convention, from the side to move: 0 = draw,
+// 22 - k for a win with the winner's k-th stone (positive = side to move wins).
+
+const int SOLVER_MIN_SCORE = -(ROWS * COLS) / 2 + 3;
+const int SOLVER_MAX_SCORE = (ROWS * COLS + 1) / 2 - 3;
+const int DEFAULT_SOLVER_TABLE_MB = 64;
+
+struct SolverPosition {
+    uint64_t current = 0; // Stones of the side to move
+    uint64_t mask = 0;
+    int moves = 0;
+
+    uint64_t key() const { return current + mask; } // Unique: same idea as getPositionKey
+
+    bool canPlay(int col) const { return (mask & (1ULL << (col * COL_BITS + ROWS - 1))) == 0; }
+
+    void play(uint64_t move) {
+        current ^= mask;
+        mask |= move;
+        moves++;
+    }
+
+    uint64_t possible() const { return playableCells(mask); }
+    uint64_t ownWinningCells() const { return winningCells(current, mask); }
+    uint64_t opponentWinningCells() const { return winningCells(current ^ mask, mask); }
+    bool canWinNext() const { return ownWinningCells() & possible(); }
+
+    // Moves that don't hand the opponent an immediate win (0 if every move loses)
+    uint64_t possibleNonLosingMoves() const {
+        uint64_t candidates = possible();
+        uint64_t opponentWins = opponentWinningCells();
+        uint64_t forced = candidates & opponentWins;
+        if (forced) {
+            if (forced & (forced - 1)) return 0; // Two threats at once
+            candidates = forced;
+        }
+        return candidates & ~(opponentWins >> 1);
+    }
+
+    int moveScore(uint64_t move) const { return popcount64(winningCells(current | move, mask)); }
+};
+
+SolverPosition toSolverPosition(char b[ROWS][COLS]) {
+    BitPosition p = toBitPosition(b);
+    SolverPosition s;
+    s.mask = p.mask;
+    s.moves = popcount64(p.mask);
+    s.current = (s.moves % 2 == 0) ? p.x : p.o; // X moves first
+    return s;
+}
+
+struct Solver {
+    // Entry = key << 8 | stored value; a value above the score range encodes a lower bound
+    vector<uint64_t> table;
+    uint64_t indexMask = 0;
+    uint64_t nodes = 0;
+    int columnOrder[COLS];
+
+    explicit Solver(int megabytes = DEFAULT_SOLVER_TABLE_MB) {
+        size_t count = 1, wanted = max<size_t>(1, (size_t)megabytes * 1024 * 1024 / sizeof(uint64_t));
+        while (count * 2 <= wanted) count *= 2;
+        table.assign(count, 0);
+        indexMask = count - 1;
+        for (int i = 0; i < COLS; i++) columnOrder[i] = COLS / 2 + (1 - 2 * (i % 2)) * (i + 1) / 2; // Center first
+    }
+
+    void reset() { fill(table.begin(), table.end(), 0); nodes = 0; }
+
+    int probe(uint64_t key) const {
+        uint64_t e = table[(key * 0x9E3779B97F4A7C15ULL >> 16) & indexMask];
+        return (e >> 8) == key ? (int)(e & 0xFF) : 0;
+    }
+
+    void store(uint64_t key, int value) {
+        table[(key * 0x9E3779B97F4A7C15ULL >> 16) & indexMask] = (key << 8) | (uint64_t)value;
+    }
+
+    // Requires: no immediate win for the side to move, alpha < beta
+    HOT_KERNEL int negamax(const SolverPosition& p, int alpha, int beta) {
+        nodes++;
+        uint64_t next = p.possibleNonLosingMoves();
+        if (next == 0) return -(ROWS * COLS - p.moves) / 2; // Every move loses at once
+        if (p.moves >= ROWS * COLS - 2) return 0;
+
+        int minScore = -(ROWS * COLS - 2 - p.moves) / 2; // Opponent can't win on their next move
+        if (alpha < minScore) { alpha = minScore; if (alpha >= beta) return alpha; }
+        int maxScore = (ROWS * COLS - 1 - p.moves) / 2;  // We can't win on our next move
+
+        uint64_t key = p.key();
+        int stored = probe(key);
+        if (stored) {
+            if (stored > SOLVER_MAX_SCORE - SOLVER_MIN_SCORE + 1) { // Lower bound
+                minScore = stored + 2 * SOLVER_MIN_SCORE - SOLVER_MAX_SCORE - 2;
+                if (alpha < minScore) { alpha = minScore; if (alpha >= beta) return alpha; }
+            } else {                                               // Upper bound
+                maxScore = stored + SOLVER_MIN_SCORE - 1;
+                if (beta > maxScore) { beta = maxScore; if (alpha >= beta) return beta; }
+            }
+        }
+        if (beta > maxScore) { beta = maxScore; if (alpha >= beta) return beta; }
+
+        // Order by how many winning cells the move creates (stable on column order)
+        uint64_t ordered[COLS];
+        int scores[COLS];
+        int count = 0;
+        for (int i = 0; i < COLS; i++) {
+            uint64_t move = next & columnMask(columnOrder[i]);
+            if (!move) continue;
+            int s = p.moveScore(move);
+            int j = count++;
+            for (; j > 0 && scores[j - 1] < s; j--) { ordered[j] = ordered[j - 1]; scores[j] = scores[j - 1]; }
+            ordered[j] = move;
+            scores[j] = s;
+        }
+
+        for (int i = 0; i < count; i++) {
+            SolverPosition child = p;
+            child.play(ordered[i]);
+            int score = -negamax(child, -beta, -alpha);
+            if (score >= beta) {
+                store(key, score + SOLVER_MAX_SCORE - 2 * SOLVER_MIN_SCORE + 2);
+                return score;
+            }
+            if (score > alpha) alpha = score;
+        }
+        store(key, alpha - SOLVER_MIN_SCORE + 1);
+        return alpha;
+    }
+
+    // Exact score of a position that is not already won
+    int solve(const SolverPosition& p) {
+        if (p.canWinNext()) return (ROWS * COLS + 1 - p.moves) / 2;
+        int lo = -(ROWS * COLS - p.moves) / 2;
+        int hi = (ROWS * COLS + 1 - p.moves) / 2;
+        while (lo < hi) { // Null-window searches converge on the exact score
+            int med = lo + (hi - lo) / 2;
+            if (med <= 0 && lo / 2 < med) med = lo / 2;
+            else if (med >= 0 && hi / 2 > med) med = hi / 2;
+            int r = negamax(p, med, med + 1);
+            if (r <= med) hi = r; else lo = r;
+        }
+        return lo;
+    }
+};
+
+// --- AI MOVE SELECTION ---
+
+// One-ply scan: a winning column for 'piece', else a column that blocks the
+// opponent's immediate win (classic mode only). Returns -1 if neither exists.
+int findImmediateMove(char b[ROWS][COLS], char piece, bool isScoreAttack) {
+    if (isScoreAttack) return -1;
+    char opponent = (piece == 'O') ? 'X' : 'O';
+    for (int col = 0; col < COLS; col++) {
+        int row = getNextOpenRow(b, col);
+        if (row == -1) continue;
+        b[row][col] = piece;
+        bool wins = checkWin(b, piece);
+        b[row][col] = opponent;
+        bool blocks = checkWin(b, opponent);
+        b[row][col] = ' ';
+        if (wins || blocks) return col;
+    }
+    return -1;
+}
+
+int firstLegalColumn(char b[ROWS][COLS]) {
+    for(int k=0; k<COLS; k++) if(getNextOpenRow(b, k) != -1) return k;
+    return -1;
+}
+
+int randomLegalColumn(char b[ROWS][COLS], mt19937& rng) {
+    vector<int> legal;
+    for (int c = 0; c < COLS; c++) if (getNextOpenRow(b, c) != -1) legal.push_back(c);
+    return legal[uniform_int_distribution<int>(0, (int)legal.size() - 1)(rng)];
+}
+
+// Full AI turn for either side: immediate win/block scan, then minimax at the
+// adaptive depth. Works on a copy, so the caller's board is left untouched.
+int findAIMove(char b[ROWS][COLS], char piece, int baseDepth, bool isScoreAttack) {
+    if (deterministicMode) clearMemo();
+    newSearchGeneration();
+    char boardCopy[ROWS][COLS];
+    for(int i=0; i<ROWS; i++) for(int j=0; j<COLS; j++) boardCopy[i][j] = b[i][j];
+
+    int targetCol = findImmediateMove(boardCopy, piece, isScoreAttack);
+    if (targetCol == -1) {
+        int adaptive_depth = getAdaptiveDepth(boardCopy, baseDepth);
+        pair<int, int> result = parallelRootSearch(boardCopy, adaptive_depth, piece == 'O',
+                                                   isScoreAttack, rootSearchThreads);
+        targetCol = result.first;
+        searchStats.rootScore = result.second;
+        searchStats.rootScored = true;
+        searchStats.completedDepth = adaptive_depth;
+    }
+    if (targetCol == -1) targetCol = firstLegalColumn(b);
+    return targetCol;
+}
+
+// Same turn under a time and/or node budget: iterative deepening, keeping the
+// move of the deepest iteration that finished within the budget.
+int findAIMoveWithin(char b[ROWS][COLS], char piece, const SearchBudget& budget, bool isScoreAttack) {
+    if (deterministicMode) clearMemo();
+    newSearchGeneration();
+    char boardCopy[ROWS][COLS];
+    for(int i=0; i<ROWS; i++) for(int j=0; j<COLS; j++) boardCopy[i][j] = b[i][j];
+
+    int targetCol = findImmediateMove(boardCopy, piece, isScoreAttack);
+    if (targetCol != -1) return targetCol;
+
+    searchLimits = limitsFor(budget);
+    searchAborted = false;
+    for (int depth = 1; depth <= budget.maxDepth; depth++) {
+        pair<int, int> result = parallelRootSearch(boardCopy, depth, piece == 'O', isScoreAttack, rootSearchThreads);
+        if (searchAborted) break;
+        searchStats.completedDepth = depth;
+        if (result.first != -1) {
+            targetCol = result.first;
+            searchStats.rootScore = result.second;
+            searchStats.rootScored = true;
+        }
+    }
+    searchLimits = SearchLimits();
+    searchAborted = false;
+
+    if (targetCol == -1) targetCol = firstLegalColumn(b);
+    return targetCol;
+}
+
+// --- DIFFICULTY PROFILES ---
+// Levels are node budgets (with a wall-clock safety cap), so the CPU cost of a
+// move is bounded no matter how complex the position is. Weaker levels add
+// leaf-evaluation noise and sometimes play a random move that doesn't lose at once.
+
+struct DifficultyProfile {
+    string name;
+    SearchBudget budget;
+    int evalNoise;
+    double blunderRate;
+};
+
+const vector<DifficultyProfile> DIFFICULTY_PROFILES = {
+    //  name       {ms,   nodes,  max depth}  noise  blunder
+    {"EASY",     {250,   2000,   4},         300,   0.25},
+    {"MEDIUM",   {1000,  20000,  8},         100,   0.08},
+    {"HARD",     {3000,  150000, ROWS*COLS}, 0,     0.0},
+    {"EXPERT",   {6000,  600000, ROWS*COLS}, 0,     0.0},
+};
+
+// Random column that neither misses an immediate block nor plays under an
+// opponent winning cell (falls back to any legal column).
+int randomSafeColumn(char b[ROWS][COLS], char piece, bool isScoreAttack, mt19937& rng) {
+    vector<int> cols;
+    if (!isScoreAttack) {
+        BitPosition pos = toBitPosition(b);
+        uint64_t opp = (piece == 'O') ? pos.x : pos.o;
+        uint64_t oppWins = winningCells(opp, pos.mask);
+        uint64_t safe = playableCells(pos.mask) & ~(oppWins >> 1);
+        for (int c = 0; c < COLS; c++) if (safe & columnMask(c)) cols.push_back(c);
+    }
+    if (cols.empty()) return randomLegalColumn(b, rng);
+    return cols[uniform_int_distribution<int>(0, (int)cols.size() - 1)(rng)];
+}
+
+int findAIMoveForProfile(char b[ROWS][COLS], char piece, const DifficultyProfile& profile, bool isScoreAttack, mt19937& rng) {
+    int immediate = findImmediateMove(b, piece, isScoreAttack);
+    if (immediate != -1) return immediate;
+    if (profile.blunderRate > 0 && uniform_real_distribution<double>(0, 1)(rng) < profile.blunderRate) {
+        return randomSafeColumn(b, piece, isScoreAttack, rng);
+    }
+
+    SearchTuning saved = searchTuning;
+    searchTuning.evalNoise = profile.evalNoise;
+    searchTuning.noiseSeed = rng();
+    int col = findAIMoveWithin(b, piece, profile.budget, isScoreAttack);
+    searchTuning = saved;
+    return col;
+}
+
+// --- LATENCY HISTOGRAMS ---
+// HDR-style histogram: each power-of-two range of microseconds is split into
+// 64 linear sub-buckets, so any recorded value is known to within ~1.6%.
+// Counters are atomics; recording never blocks.
+
+const int HIST_SUB_BITS = 6;
+const int HIST_SUB_COUNT = 1 << HIST_SUB_BITS;
+const int HIST_RANGES = 38;  // Up to 2^(38+5) us, far beyond any move
+
+struct LatencyHistogram {
+    atomic<uint64_t> counts[HIST_RANGES * HIST_SUB_COUNT];
+    atomic<uint64_t> total{0};
+    atomic<uint64_t> sumUs{0};
+    atomic<uint64_t> maxUs{0};
+
+    LatencyHistogram() { for (auto& c : counts) c.store(0, memory_order_relaxed); }
+
+    static int indexOf(uint64_t us) {
+        if (us < (uint64_t)HIST_SUB_COUNT) return (int)us;
+        int msb = 63 - __builtin_clzll(us);
+        int idx = (msb - HIST_SUB_BITS + 1) * HIST_SUB_COUNT + (int)((us >> (msb - HIST_SUB_BITS)) & (HIST_SUB_COUNT - 1));
+        return min(idx, HIST_RANGES * HIST_SUB_COUNT - 1);
+    }
+
+    // Lowest value that maps to bucket 'idx'
+    static uint64_t valueOf(int idx) {
+        if (idx < HIST_SUB_COUNT) return (uint64_t)idx;
+        int range = idx / HIST_SUB_COUNT;
+        int msb = range + HIST_SUB_BITS - 1;
+        return (1ULL << msb) + ((uint64_t)(idx % HIST_SUB_COUNT) << (msb - HIST_SUB_BITS));
+    }
+
+    void record(uint64_t us) {
+        counts[indexOf(us)].fetch_add(1, memory_order_relaxed);
+        total.fetch_add(1, memory_order_relaxed);
+        sumUs.fetch_add(us, memory_order_relaxed);
+        uint64_t seen = maxUs.load(memory_order_relaxed);
+        while (us > seen && !maxUs.compare_exchange_weak(seen, us, memory_order_relaxed)) {}
+    }
+
+    uint64_t valueAtPercentile(double p) const {
+        uint64_t n = total.load(memory_order_relaxed);
+        if (n == 0) return 0;
+        uint64_t target = (uint64_t)ceil(p / 100.0 * n);
+        uint64_t seen = 0;
+        for (int i = 0; i < HIST_RANGES * HIST_SUB_COUNT; i++) {
+            seen += counts[i].load(memory_order_relaxed);
+            if (seen >= max<uint64_t>(target, 1)) return min(valueOf(i), maxUs.load(memory_order_relaxed));
+        }
+        return maxUs.load(memory_order_relaxed);
+    }
+};
+
+// Game phase, with the same move-count thresholds as getAdaptiveDepth
+const int PHASE_COUNT = 3;
+const string PHASE_NAMES[PHASE_COUNT] = {"opening", "middlegame", "endgame"};
+
+int gamePhase(char b[ROWS][COLS]) {
+    int moves_played = 0;
+    for (int i=0; i<ROWS; i++) for(int j=0; j<COLS; j++) if(b[i][j]!=' ') moves_played++;
+    if (moves_played < 8) return 0;
+    if (moves_played > 30) return 2;
+    return 1;
+}
+
+// AI move compute time, segmented by difficulty x phase x mode
+struct LatencyRegistry {
+    static const int LEVELS = 4;
+    unique_ptr<LatencyHistogram> segments[LEVELS][PHASE_COUNT][2];
+
+    LatencyRegistry() {
+        for (auto& level : segments) for (auto& phase : level) for (auto& mode : phase) mode.reset(new LatencyHistogram());
+    }
+
+    void record(int level, int phase, bool isScoreAttack, uint64_t us) {
+        segments[min(max(level, 0), LEVELS - 1)][phase][isScoreAttack ? 1 : 0]->record(us);
+    }
+
+    // Summary per non-empty segment, then every non-empty bucket, as CSV
+    void exportTo(ostream& out) const {
+        out << "segment,count,mean_us,p50_us,p90_us,p99_us,p999_us,max_us\n";
+        forEachSegment([&](const string& name, const LatencyHistogram& h) {
+            uint64_t n = h.total.load();
+            out << name << "," << n << "," << h.sumUs.load() / n << "," << h.valueAtPercentile(50) << ","
+                << h.valueAtPercentile(90) << "," << h.valueAtPercentile(99) << "," << h.valueAtPercentile(99.9)
+                << "," << h.maxUs.load() << "\n";
+        });
+        out << "\nsegment,bucket_us,count\n";
+        forEachSegment([&](const string& name, const LatencyHistogram& h) {
+            for (int i = 0; i < HIST_RANGES * HIST_SUB_COUNT; i++) {
+                uint64_t c = h.counts[i].load();
+                if (c) out << name << "," << LatencyHistogram::valueOf(i) << "," << c << "\n";
+            }
+        });
+    }
+
+    template <typename F>
+    void forEachSegment(F visit) const {
+        for (int l = 0; l < LEVELS; l++) for (int p = 0; p < PHASE_COUNT; p++) for (int m = 0; m < 2; m++) {
+            const LatencyHistogram& h = *segments[l][p][m];
+            if (h.total.load() == 0) continue;
+            string name = DIFFICULTY_PROFILES[l].name + "/" + PHASE_NAMES[p] + "/" + (m ? "score-attack" : "classic");
+            visit(name, h);
+        }
+    }
+};
+
+LatencyRegistry latencyRegistry;
+string latencyExportPath;              // --latency-out; empty = export disabled
+atomic<bool> latencyExportRequested(false);
+
+void exportLatencyHistograms() {
+    if (latencyExportPath.empty()) return;
+    ofstream out(latencyExportPath, ios::trunc);
+    if (out) latencyRegistry.exportTo(out);
+}
+
+// On demand: SIGUSR1 asks for an export at the next safe point (signal handlers can't do I/O)
+void onLatencyExportSignal(int) {
+    latencyExportRequested = true;
+}
+
+void exportLatencyIfRequested() {
+    if (latencyExportRequested.exchange(false)) exportLatencyHistograms();
+}
+
+// Timed wrapper around findAIMoveForProfile that feeds the registry
+int timedAIMove(char b[ROWS][COLS], char piece, int level, bool isScoreAttack, mt19937& rng) {
+    int phase = gamePhase(b);
+    auto start = chrono::steady_clock::now();
+    int col = findAIMoveForProfile(b, piece, DIFFICULTY_PROFILES[level], isScoreAttack, rng);
+    uint64_t us = (uint64_t)chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+    latencyRegistry.record(level, phase, isScoreAttack, us);
+    return col;
+}
+
+int calculateFinalScore(char player) {
+    int score = 0;
+    // Horizontal
+    for (int r = 0; r < ROWS; r++) { 
+        int streak = 0; 
+        for (int c = 0; c < COLS; c++) { 
+            if (board[r][c] == player) streak++; 
+            else { 
+                if (streak >= 4) score += (streak - 3); 
+                streak = 0; 
+            } 
+        } 
+        if (streak >= 4) score += (streak - 3);
+    }
+    // Vertical
+    for (int c = 0; c < COLS; c++) {
+        int streak = 0; 
+        for (int r = 0; r < ROWS; r++) { 
+            if (board[r][c] == player) streak++; 
+            else { 
+                if (streak >= 4) score += (streak - 3); 
+                streak = 0; 
+            } 
+        } 
+        if (streak >= 4) score += (streak - 3);
+    }
+    // Diagonal (Down-Right)
+    for (int r = 0; r < ROWS - 3; r++) {
+        for (int c = 0; c < COLS - 3; c++) {
+            if (board[r][c] == player && board[r+1][c+1] == player && board[r+2][c+2] == player && board[r+3][c+3] == player) { 
+                score++; 
+            }
+        }
+    }
+    // Diagonal (Up-Right)
+    for (int r = 3; r < ROWS; r++) {
+        for (int c = 0; c < COLS - 3; c++) {
+            if (board[r][c] == player && board[r-1][c+1] == player && board[r-2][c+2] == player && board[r-3][c+3] == player) { 
+                score++; 
+            }
+        }
+    }
+    return score;
+}
+
+// --- SELF-PLAY DATA GENERATOR ---
+
+// Completed 4-in-a-row windows for 'piece' on any board. Same total as
+// calculateFinalScore (a streak of 5 counts as 2 lines), which only reads the global board.
+int countLines(char b[ROWS][COLS], char piece) {
+    int lines = 0;
+    for (int r = 0; r < ROWS; r++) for (int c = 0; c < COLS - 3; c++)
+        if (b[r][c]==piece && b[r][c+1]==piece && b[r][c+2]==piece && b[r][c+3]==piece) lines++;
+    for (int r = 0; r < ROWS - 3; r++) for (int c = 0; c < COLS; c++)
+        if (b[r][c]==piece && b[r+1][c]==piece && b[r+2][c]==piece && b[r+3][c]==piece) lines++;
+    for (int r = 0; r < ROWS - 3; r++) {
+        for (int c = 0; c < COLS - 3; c++)
+            if (b[r][c]==piece && b[r+1][c+1]==piece && b[r+2][c+2]==piece && b[r+3][c+3]==piece) lines++;
+        for (int c = 3; c < COLS; c++)
+            if (b[r][c]==piece && b[r+1][c-1]==piece && b[r+2][c-2]==piece && b[r+3][c-3]==piece) lines++;
+    }
+    return lines;
+}
+
+// Sharded set of position keys. Each shard has its own lock, so worker threads
+// only contend when two of them hit the same shard at the same time.
+const int KEY_SET_SHARDS = 64;
+
+struct ConcurrentKeySet {
+    mutex locks[KEY_SET_SHARDS];
+    unordered_set<uint64_t> shards[KEY_SET_SHARDS];
+
+    // Returns true if the key was not seen before.
+    bool insert(uint64_t key) {
+        int s = (int)((key * 0x9E3779B97F4A7C15ULL) >> 58) % KEY_SET_SHARDS;
+        lock_guard<mutex> guard(locks[s]);
+        return shards[s].insert(key).second;
+    }
+};
+
+// One labeled training sample. Written to disk as 16 little-endian bytes:
+// key (8) | search score (4) | outcome (1) | ply (1) | side to move (1) | reserved (1)
+// Score and outcome are both from the side to move's point of view.
+struct TrainingRecord {
+    uint64_t key;
+    int32_t score;
+    int8_t outcome; // +1 win, 0 draw, -1 loss
+    uint8_t ply;
+    char side;      // 'X' or 'O'
+};
+
+const int TRAINING_RECORD_SIZE = 16;
+
+struct SelfPlayConfig {
+    int games = 1000;
+    int threads = 1;
+    int depth = 4;
+    int openingPlies = 4;       // Uniformly random moves before labeling starts
+    double temperature = 0.0;   // 0 = always play the best move
+    unsigned int seed = 0;
+    bool isScoreAttack = false;
+    string outPath = "selfplay.bin";
+};
+
+// Streams records to disk. Workers hand over whole batches, so the lock is taken
+// once per game instead of once per position.
+struct TrainingWriter {
+    ofstream out;
+    mutex lock;
+    uint64_t written = 0;
+
+    bool open(const string& path) {
+        out.open(path, ios::binary | ios::trunc);
+        if (!out) return false;
+        const char header[8] = {'C', '4', 'T', 'D', 1, TRAINING_RECORD_SIZE, ROWS, COLS};
+        out.write(header, sizeof(header));
+        return true;
+    }
+
+    void writeBatch(const vector<TrainingRecord>& batch) {
+        if (batch.empty()) return;
+        vector<char> bytes(batch.size() * TRAINING_RECORD_SIZE, 0);
+        for (size_t i = 0; i < batch.size(); i++) {
+            char* p = &bytes[i * TRAINING_RECORD_SIZE];
+            for (int k = 0; k < 8; k++) p[k] = (char)(batch[i].key >> (8 * k));
+            uint32_t score = (uint32_t)batch[i].score;
+            for (int k = 0; k < 4; k++) p[8 + k] = (char)(score >> (8 * k));
+            p[12] = (char)batch[i].outcome;
+            p[13] = (char)batch[i].ply;
+            p[14] = batch[i].side;
+        }
+        lock_guard<mutex> guard(lock);
+        out.write(bytes.data(), bytes.size());
+        written += batch.size();
+    }
+};
+
+// Scores every legal root move with a full-window search (from 'O's point of view),
+// so the temperature can be applied to the whole move list.
+vector<pair<int, int>> scoreRootMoves(char b[ROWS][COLS], char piece, int depth, bool isScoreAttack) {
+    vector<pair<int, int>> scored;
+    bool maximizingPlayer = (piece == 'O');
+    for (int col : getOptimizedMoves(b, maximizingPlayer)) {
+        int row = getNextOpenRow(b, col);
+        b[row][col] = piece;
+        int score = minimax(b, depth - 1, INT_MIN, INT_MAX, !maximizingPlayer, isScoreAttack, depth - 1).second;
+        b[row][col] = ' ';
+        scored.push_back({col, score});
+    }
+    return scored;
+}
+
+// Picks a move with probability proportional to exp((score - best) / temperature).
+int pickMoveWithTemperature(const vector<pair<int, int>>& scored, bool maximizingPlayer, double temperature, mt19937& rng) {
+    int bestIdx = 0;
+    for (size_t i = 1; i < scored.size(); i++) {
+        if (maximizingPlayer ? scored[i].second > scored[bestIdx].second : scored[i].second < scored[bestIdx].second) bestIdx = (int)i;
+    }
+    if (temperature <= 0.0) return scored[bestIdx].first;
+
+    vector<double> weights;
+    for (auto& m : scored) {
+        double diff = maximizingPlayer ? (double)m.second - scored[bestIdx].second : (double)scored[bestIdx].second - m.second;
+        weights.push_back(exp(diff / temperature));
+    }
+    discrete_distribution<int> pick(weights.begin(), weights.end());
+    return scored[pick(rng)].first;
+}
+
+// Plays one game and returns its newly seen (deduplicated) positions, labeled.
+vector<TrainingRecord> playSelfPlayGame(const SelfPlayConfig& cfg, mt19937& rng, ConcurrentKeySet& seen) {
+    char b[ROWS][COLS];
+    for (int i = 0; i < ROWS; i++) for (int j = 0; j < COLS; j++) b[i][j] = ' ';
+
+    vector<TrainingRecord> records;
+    char current = 'X';
+    char winner = ' ';
+
+    for (int ply = 0; ply < ROWS * COLS; ply++) {
+        int col = -1;
+        if (ply < cfg.openingPlies) {
+            col = randomLegalColumn(b, rng);
+        } else {
+            vector<pair<int, int>> scored = scoreRootMoves(b, current, cfg.depth, cfg.isScoreAttack);
+            bool maximizingPlayer = (current == 'O');
+            int best = scored[0].second;
+            for (auto& m : scored) best = maximizingPlayer ? max(best, m.second) : min(best, m.second);
+
+            if (seen.insert(getPositionKey(b))) {
+                TrainingRecord rec;
+                rec.key = getPositionKey(b);
+                rec.score = maximizingPlayer ? best : -best;
+                rec.outcome = 0;
+                rec.ply = (uint8_t)ply;
+                rec.side = current;
+                records.push_back(rec);
+            }
+            col = pickMoveWithTemperature(scored, maximizingPlayer, cfg.temperature, rng);
+        }
+
+        b[getNextOpenRow(b, col)][col] = current;
+        if (!cfg.isScoreAttack && checkWin(b, current)) { winner = current; break; }
+        current = (current == 'X') ? 'O' : 'X';
+    }
+
+    if (cfg.isScoreAttack) {
+        int xLines = countLines(b, 'X'), oLines = countLines(b, 'O');
+        if (xLines > oLines) winner = 'X';
+        else if (oLines > xLines) winner = 'O';
+    }
+
+    for (auto& rec : records) {
+        if (winner == ' ') rec.outcome = 0;
+        else rec.outcome = (rec.side == winner) ? 1 : -1;
+    }
+    return records;
+}
+
+void runSelfPlay(const SelfPlayConfig& cfg) {
+    TrainingWriter writer;
+    if (!writer.open(cfg.outPath)) {
+        cout << " Cannot open " << cfg.outPath << " for writing.\n";
+        return;
+    }
+
+    ConcurrentKeySet seen;
+    atomic<int> nextGame(0);
+    atomic<int> gamesDone(0);
+    time_t started = time(nullptr);
+
+    auto worker = [&](int id) {
+        mt19937 rng(cfg.seed + 7919u * (unsigned int)id);
+        while (true) {
+            int g = nextGame.fetch_add(1);
+            if (g >= cfg.games) break;
+            writer.writeBatch(playSelfPlayGame(cfg, rng, seen));
+            int done = gamesDone.fetch_add(1) + 1;
+            if (done % 100 == 0) cout << " " << done << "/" << cfg.games << " games\n";
+        }
+    };
+
+    vector<thread> pool;
+    for (int t = 0; t < cfg.threads; t++) pool.emplace_back(worker, t);
+    for (auto& t : pool) t.join();
+
+    cout << " Self-play finished: " << gamesDone.load() << " games, " << writer.written
+         << " unique positions -> " << cfg.outPath << " (" << (time(nullptr) - started) << "s)\n";
+}
+
+// --- ENGINE MATCH ---
+// Plays a tuned engine against a baseline from the same random openings (each
+// opening twice, colors swapped) to weigh playing strength against nodes saved.
+
+struct MatchSide {
+    string name;
+    SearchTuning tuning;
+    uint64_t nodes = 0;
+    uint64_t moves = 0;
+};
+
+struct MatchConfig {
+    int games = 200;
+    int threads = 1;
+    int depth = 6;
+    int openingPlies = 4;
+    SearchBudget budget;        // Time or nodes set: both sides search to a budget instead of a depth
+    unsigned int seed = 0;
+    bool isScoreAttack = false;
+};
+
+// Returns +1 if sides[0] won, -1 if sides[1] won, 0 for a draw.
+// 'gameHash' receives a hash of the full move sequence, for replay checks.
+int playMatchGame(const MatchConfig& cfg, int game, MatchSide sides[2], uint64_t nodes[2], uint64_t moves[2], uint64_t& gameHash) {
+    char b[ROWS][COLS];
+    for (int i = 0; i < ROWS; i++) for (int j = 0; j < COLS; j++) b[i][j] = ' ';
+    mt19937 rng(cfg.seed + 104729u * (unsigned int)(game / 2)); // Both games of a pair share the opening
+    int xSide = game % 2;
+
+    char current = 'X';
+    gameHash = FNV_OFFSET;
+    for (int ply = 0; ply < ROWS * COLS; ply++) {
+        int col;
+        if (ply < cfg.openingPlies) {
+            col = randomLegalColumn(b, rng);
+        } else {
+            int side = (current == 'X') ? xSide : 1 - xSide;
+            searchTuning = sides[side].tuning;
+            clearMemo(); // Memo entries were computed under the other side's tuning
+            searchStats = SearchStats();
+            if (cfg.budget.timeMs > 0 || cfg.budget.nodes > 0) col = findAIMoveWithin(b, current, cfg.budget, cfg.isScoreAttack);
+            else col = findAIMove(b, current, cfg.depth, cfg.isScoreAttack);
+            nodes[side] += searchStats.nodes;
+            moves[side]++;
+        }
+        b[getNextOpenRow(b, col)][col] = current;
+        gameHash = fnv1a(gameHash, (uint64_t)col);
+        if (!cfg.isScoreAttack && checkWin(b, current)) return ((current == 'X') == (xSide == 0)) ? 1 : -1;
+        current = (current == 'X') ? 'O' : 'X';
+    }
+    if (!cfg.isScoreAttack) return 0;
+    int xLines = countLines(b, 'X'), oLines = countLines(b, 'O');
+    if (xLines == oLines) return 0;
+    return ((xLines > oLines) == (xSide == 0)) ? 1 : -1;
+}
+
+double eloFromScore(double p) {
+    p = min(max(p, 0.001), 0.999);
+    return -400.0 * log10(1.0 / p - 1.0);
+}
+
+void runMatch(const MatchConfig& cfg, MatchSide sides[2]) {
+    atomic<int> nextGame(0), wins(0), draws(0), losses(0);
+    mutex statsLock;
+    vector<uint64_t> gameHashes(cfg.games, 0); // Folded in game order, so thread scheduling doesn't matter
+
+    auto worker = [&]() {
+        uint64_t nodes[2] = {0, 0}, moves[2] = {0, 0};
+        while (true) {
+            int g = nextGame.fetch_add(1);
+            if (g >= cfg.games) break;
+            int result = playMatchGame(cfg, g, sides, nodes, moves, gameHashes[g]);
+            if (result > 0) wins++; else if (result < 0) losses++; else draws++;
+        }
+        lock_guard<mutex> guard(statsLock);
+        for (int s = 0; s < 2; s++) { sides[s].nodes += nodes[s]; sides[s].moves += moves[s]; }
+    };
+
+    vector<thread> pool;
+    for (int t = 0; t < cfg.threads; t++) pool.emplace_back(worker);
+    for (auto& t : pool) t.join();
+
+    int n = wins + draws + losses;
+    double p = (wins + 0.5 * draws) / max(n, 1);
+    double variance = (wins * (1 - p) * (1 - p) + draws * (0.5 - p) * (0.5 - p) + losses * p * p) / max(n, 1);
+    double margin = 1.96 * sqrt(variance / max(n, 1));
+
+    cout << " Match: " << sides[0].name << " vs " << sides[1].name << ", " << n << " games, ";
+    if (cfg.budget.nodes > 0) cout << cfg.budget.nodes << " nodes/move\n";
+    else if (cfg.budget.timeMs > 0) cout << cfg.budget.timeMs << " ms/move\n";
+    else cout << "depth " << cfg.depth << "\n";
+    cout << "  +" << wins << " =" << draws << " -" << losses << "  score " << (100.0 * p) << "%\n";
+    cout << "  Elo " << eloFromScore(p) << "  [" << eloFromScore(p - margin) << ", " << eloFromScore(p + margin) << "] (95%)\n";
+    for (int s = 0; s < 2; s++) {
+        cout << "  " << sides[s].name << ": " << (sides[s].nodes / max<uint64_t>(sides[s].moves, 1)) << " nodes/move\n";
+    }
+    if (deterministicMode) {
+        uint64_t h = FNV_OFFSET;
+        for (uint64_t g : gameHashes) h = fnv1a(h, g);
+        cout << "  Reproducibility hash: " << hex << h << dec << "\n";
+    }
+    if (sides[1].nodes > 0) {
+        cout << "  Node savings: " << (100.0 - 100.0 * sides[0].nodes / max<uint64_t>(sides[1].nodes, 1)
+                                         * sides[1].moves / max<uint64_t>(sides[0].moves, 1)) << "% per move\n";
+    }
+}
+
+// --- LOAD GENERATOR ---
+// Simulates many concurrent human-vs-AI games: each session's "human" thinks for
+// a log-normally distributed time, plays a random safe move, and then asks for
+// an AI move. Requests queue up for a fixed pool of worker threads, so the
+// measured latency includes queueing, as a real server would see it.
+
+struct LoadGenConfig {
+    int sessions = 100;
+    int workers = 1;
+    int level = 1;                // Index into DIFFICULTY_PROFILES
+    double thinkMedianMs = 3000;  // Human think time per move (log-normal)
+    double thinkSigma = 0.6;
+    int durationSec = 30;
+    unsigned int seed = 0;
+    bool isScoreAttack = false;
+};
+
+struct LoadSession {
+    char b[ROWS][COLS];
+    int moves = 0;
+    mt19937 rng;
+};
+
+typedef chrono::steady_clock::time_point TimePoint;
+
+// Resident set size in bytes (Linux); 0 where it cannot be read.
+size_t residentMemoryBytes() {
+    #ifdef __linux__
+        ifstream statm("/proc/self/statm");
+        size_t pages = 0, resident = 0;
+        if (statm >> pages >> resident) return resident * 4096;
+    #endif
+    return 0;
+}
+
+void resetSession(LoadSession& s) {
+    for (int i = 0; i < ROWS; i++) for (int j = 0; j < COLS; j++) s.b[i][j] = ' ';
+    s.moves = 0;
+}
+
+// One human move + one AI move. Returns false when the game ended (and was restarted).
+bool advanceSession(LoadSession& s, const LoadGenConfig& cfg) {
+    char players[2] = {'X', 'O'};
+    for (char piece : players) {
+        int col = (piece == 'X') ? randomSafeColumn(s.b, 'X', cfg.isScoreAttack, s.rng)
+                                 : timedAIMove(s.b, 'O', cfg.level, cfg.isScoreAttack, s.rng);
+        s.b[getNextOpenRow(s.b, col)][col] = piece;
+        s.moves++;
+        if ((!cfg.isScoreAttack && checkWin(s.b, piece)) || s.moves >= ROWS * COLS) {
+            resetSession(s);
+            return false;
+        }
+    }
+    return true;
+}
+
+void runLoadGenerator(const LoadGenConfig& cfg) {
+    vector<LoadSession> sessions(cfg.sessions);
+    size_t rssBefore = residentMemoryBytes();
+
+    // Pending requests, earliest first
+    typedef pair<TimePoint, int> Request;
+    priority_queue<Request, vector<Request>, greater<Request>> pending;
+    mutex queueLock;
+    condition_variable queueReady;
+
+    mt19937 seeder(cfg.seed);
+    lognormal_distribution<double> firstThink(log(cfg.thinkMedianMs), cfg.thinkSigma);
+    TimePoint start = chrono::steady_clock::now();
+    TimePoint end = start + chrono::seconds(cfg.durationSec);
+    for (int i = 0; i < cfg.sessions; i++) {
+        sessions[i].rng.seed(seeder());
+        resetSession(sessions[i]);
+        // Stagger the first requests so the sessions don't all fire at once
+        pending.push({start + chrono::microseconds((int64_t)(firstThink(seeder) * 1000)), i});
+    }
+
+    LatencyHistogram endToEnd;     // Request due -> AI move done, including queueing
+    atomic<uint64_t> gamesFinished(0);
+    atomic<bool> stopping(false);
+    clock_t cpuStart = clock();
+
+    auto worker = [&]() {
+        while (true) {
+            Request req;
+            {
+                unique_lock<mutex> guard(queueLock);
+                while (!stopping && (pending.empty() || pending.top().first > chrono::steady_clock::now())) {
+                    if (pending.empty()) queueReady.wait(guard);
+                    else queueReady.wait_until(guard, pending.top().first);
+                }
+                if (stopping) return;
+                req = pending.top();
+                pending.pop();
+            }
+
+            LoadSession& s = sessions[req.second];
+            bool ongoing = advanceSession(s, cfg);
+            TimePoint done = chrono::steady_clock::now();
+            endToEnd.record((uint64_t)max<int64_t>(0, chrono::duration_cast<chrono::microseconds>(done - req.first).count()));
+            if (!ongoing) gamesFinished++;
+
+            lognormal_distribution<double> think(log(cfg.thinkMedianMs), cfg.thinkSigma);
+            TimePoint next = done + chrono::microseconds((int64_t)(think(s.rng) * 1000));
+            {
+                lock_guard<mutex> guard(queueLock);
+                pending.push({next, req.second});
+            }
+            queueReady.notify_one();
+        }
+    };
+
+    vector<thread> pool;
+    for (int w = 0; w < cfg.workers; w++) pool.emplace_back(worker);
+    while (chrono::steady_clock::now() < end) {
+        this_thread::sleep_for(chrono::milliseconds(100));
+        exportLatencyIfRequested();
+    }
+    {
+        lock_guard<mutex> guard(queueLock);
+        stopping = true;
+    }
+    queueReady.notify_all();
+    for (auto& t : pool) t.join();
+
+    double wallSec = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    double cpuSec = (double)(clock() - cpuStart) / CLOCKS_PER_SEC; // Process CPU time, all threads
+    unsigned int cores = max(1u, thread::hardware_concurrency());
+    size_t rssAfter = residentMemoryBytes();
+
+    uint64_t served = endToEnd.total.load();
+    // Each session asks once per mean think time; a log-normal's mean is median * exp(sigma^2 / 2)
+    double meanThinkMs = cfg.thinkMedianMs * exp(cfg.thinkSigma * cfg.thinkSigma / 2);
+    double offered = cfg.sessions / (meanThinkMs / 1000.0);
+
+    cout << " Load: " << cfg.sessions << " sessions, " << cfg.workers << " workers, level "
+         << DIFFICULTY_PROFILES[cfg.level].name << ", think median " << cfg.thinkMedianMs << " ms, " << wallSec << " s\n";
+    cout << "  AI moves: " << served << " (" << served / wallSec << "/s, offered ~"
+         << offered << "/s), games finished: " << gamesFinished.load() << "\n";
+    cout << "  Move latency ms: p50 " << endToEnd.valueAtPercentile(50) / 1000.0 << "  p95 " << endToEnd.valueAtPercentile(95) / 1000.0
+         << "  p99 " << endToEnd.valueAtPercentile(99) / 1000.0 << "  max " << endToEnd.maxUs.load() / 1000.0 << "\n";
+    cout << "  CPU: " << (100.0 * cpuSec / wallSec) << "% of one core, " << (100.0 * cpuSec / (wallSec * cores))
+         << "% of " << cores << " cores\n";
+    if (rssAfter > 0) {
+        cout << "  Memory: RSS " << rssAfter / (1024 * 1024) << " MB, " << (double)(rssAfter - min(rssBefore, rssAfter)) / cfg.sessions / 1024
+             << " KB per session (incl. worker memo tables)\n";
+    }
+}
+
+// --- SPECTATOR ARENA ---
+// Many AI-vs-AI games on a few game threads, watched as a grid of compact
+// boards. Each game publishes a snapshot after every move through a seqlock:
+// the game thread only ever stores (it never waits for the screen), and the
+// renderer retries or keeps the old tile if it catches a snapshot mid-update.
+// Frames are capped at --fps and only tiles whose game moved are redrawn.
+
+struct ArenaConfig {
+    int games = 16;
+    int threads = 1;
+    int searchThreads = 1;  // Root-parallel threads per search (rootSearchThreads is per thread)
+    int level = 1;          // Index into DIFFICULTY_PROFILES, both sides
+    int fps = 10;
+    int durationSec = 60;
+    int moveDelayMs = 0;    // Pause after each move, to slow games down for watching
+    unsigned int seed = 0;
+    bool isScoreAttack = false;
+};
+
+// Everything a tile shows. Plain data, copied in and out of the slot as words.
+struct ArenaSnapshot {
+    uint64_t x = 0, o = 0;  // Bitboards (BITBOARDS layout)
+    int32_t eval = 0;       // Last searched score, from X's point of view
+    uint32_t nps = 0;       // Search speed over the current game
+    uint32_t moves = 0;
+    uint32_t gamesPlayed = 0;
+    int32_t lastResult = 0; // Previous game: 1 = X won, 2 = O won, 3 = draw
+    int32_t unused = 0;
+};
+
+const int ARENA_SNAPSHOT_WORDS = sizeof(ArenaSnapshot) / sizeof(uint64_t);
+static_assert(sizeof(ArenaSnapshot) % sizeof(uint64_t) == 0, "snapshot must be whole words");
+
+struct alignas(64) ArenaSlot {
+    atomic<uint32_t> sequence{0}; // Odd while the game thread is writing
+    atomic<uint64_t> words[ARENA_SNAPSHOT_WORDS];
+
+    ArenaSlot() { for (auto& w : words) w.store(0, memory_order_relaxed); }
+
+    // Single writer per slot (the thread that owns the game)
+    void publish(const ArenaSnapshot& snap) {
+        uint64_t raw[ARENA_SNAPSHOT_WORDS];
+        memcpy(raw, &snap, sizeof(raw));
+        uint32_t s = sequence.load(memory_order_relaxed);
+        sequence.store(s + 1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_release);
+        for (int i = 0; i < ARENA_SNAPSHOT_WORDS; i++) words[i].store(raw[i], memory_order_relaxed);
+        sequence.store(s + 2, memory_order_release);
+    }
+
+    // False if every attempt overlapped a write; 'version' changes on every publish
+    bool read(ArenaSnapshot& out, uint32_t& version) const {
+        for (int attempt = 0; attempt < 4; attempt++) {
+            uint32_t before = sequence.load(memory_order_acquire);
+            if (before & 1) continue;
+            uint64_t raw[ARENA_SNAPSHOT_WORDS];
+            for (int i = 0; i < ARENA_SNAPSHOT_WORDS; i++) raw[i] = words[i].load(memory_order_relaxed);
+            atomic_thread_fence(memory_order_acquire);
+            if (sequence.load(memory_order_relaxed) != before) continue;
+            memcpy(&out, raw, sizeof(raw));
+            version = before;
+            return true;
+        }
+        return false;
+    }
+};
+
+struct ArenaGame {
+    char b[ROWS][COLS];
+    mt19937 rng;
+    uint64_t nodes = 0;
+    double searchSec = 0;
+    ArenaSnapshot snap;
+};
+
+const int ARENA_TILE_WIDTH = 17;  // 2 per cell + gap
+const int ARENA_TILE_HEIGHT = ROWS + 3; // Header, rows, eval/NPS line, gap
+const int ARENA_FIRST_LINE = 3;   // Below the banner
+
+// Terminal size in characters, with a fallback when it can't be queried
+void terminalSize(int& columns, int& lines) {
+    columns = 120;
+    lines = 40;
+    #ifndef _WIN32
+        struct winsize w;
+        if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &w) == 0 && w.ws_col > 0 && w.ws_row > 0) {
+            columns = w.ws_col;
+            lines = w.ws_row;
+        }
+    #endif
+}
+
+string formatRate(double perSec) {
+    char text[32];
+    if (perSec >= 1e6) snprintf(text, sizeof(text), "%.1fM", perSec / 1e6);
+    else if (perSec >= 1e3) snprintf(text, sizeof(text), "%.0fk", perSec / 1e3);
+    else snprintf(text, sizeof(text), "%.0f", perSec);
+    return text;
+}
+
+string formatEval(int eval) {
+    if (eval >= 1000000) return "X wins";
+    if (eval <= -1000000) return "O wins";
+    return (eval > 0 ? "+" : "") + to_string(eval);
+}
+
+void appendPadded(string& out, const string& text, int width) {
+    out += text.substr(0, width);
+    for (int i = (int)text.size(); i < width; i++) out += ' ';
+}
+
+void appendArenaTile(string& out, int index, const ArenaSnapshot& snap, int line, int column) {
+    static const char* RESULT_NAMES[4] = {"", " X", " O", " ="};
+    appendCursor(out, line, column);
+    char header[32];
+    snprintf(header, sizeof(header), "G%02d #%u p%u%s", index + 1, snap.gamesPlayed + 1, snap.moves,
+             RESULT_NAMES[min(max(snap.lastResult, 0), 3)]);
+    appendPadded(out, header, ARENA_TILE_WIDTH - 2);
+
+    for (int r = 0; r < ROWS; r++) {
+        appendCursor(out, line + 1 + r, column);
+        for (int c = 0; c < COLS; c++) {
+            uint64_t bit = 1ULL << (c * COL_BITS + (ROWS - 1 - r));
+            if (snap.x & bit) { out += RED; out += " X"; out += RESET; }
+            else if (snap.o & bit) { out += BLUE; out += " O"; out += RESET; }
+            else out += " .";
+        }
+    }
+
+    appendCursor(out, line + 1 + ROWS, column);
+    appendPadded(out, formatEval(snap.eval) + " " + formatRate(snap.nps) + "n/s", ARENA_TILE_WIDTH - 2);
+}
+
+void runArena(const ArenaConfig& cfg) {
+    vector<ArenaGame> games(cfg.games);
+    unique_ptr<ArenaSlot[]> slots(new ArenaSlot[cfg.games]);
+    atomic<bool> stopping(false);
+    atomic<uint64_t> totalNodes(0), xWins(0), oWins(0), draws(0);
+
+    mt19937 seeder(cfg.seed);
+    for (auto& g : games) {
+        for (int i = 0; i < ROWS; i++) for (int j = 0; j < COLS; j++) g.b[i][j] = ' ';
+        g.rng.seed(seeder());
+    }
+
+    // Each thread owns every threads-th game and moves its games in turn, so all
+    // boards progress together instead of one game at a time.
+    auto player = [&](int first) {
+        rootSearchThreads = cfg.searchThreads;
+        while (!stopping) {
+            for (int i = first; i < cfg.games && !stopping; i += cfg.threads) {
+                ArenaGame& g = games[i];
+                char piece = (g.snap.moves % 2 == 0) ? 'X' : 'O';
+                searchStats = SearchStats();
+                auto start = chrono::steady_clock::now();
+                int col = timedAIMove(g.b, piece, cfg.level, cfg.isScoreAttack, g.rng);
+                g.searchSec += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+                g.nodes += searchStats.nodes;
+                totalNodes.fetch_add(searchStats.nodes, memory_order_relaxed);
+
+                g.b[getNextOpenRow(g.b, col)][col] = piece;
+                g.snap.moves++;
+                if (searchStats.rootScored) g.snap.eval = -searchStats.rootScore;
+                g.snap.nps = (uint32_t)min(g.nodes / max(g.searchSec, 1e-6), 4e9);
+
+                int result = 0;
+                if (!cfg.isScoreAttack && checkWin(g.b, piece)) result = (piece == 'X') ? 1 : 2;
+                else if (g.snap.moves >= (uint32_t)(ROWS * COLS)) {
+                    int xLines = countLines(g.b, 'X'), oLines = countLines(g.b, 'O');
+                    result = (xLines > oLines) ? 1 : (oLines > xLines) ? 2 : 3;
+                }
+                if (result) {
+                    (result == 1 ? xWins : result == 2 ? oWins : draws).fetch_add(1, memory_order_relaxed);
+                    for (int r = 0; r < ROWS; r++) for (int c = 0; c < COLS; c++) g.b[r][c] = ' ';
+                    g.snap.moves = 0;
+                    g.snap.eval = 0;
+                    g.snap.gamesPlayed++;
+                    g.snap.lastResult = result;
+                    g.nodes = 0;
+                    g.searchSec = 0;
+                }
+                BitPosition pos = toBitPosition(g.b);
+                g.snap.x = pos.x;
+                g.snap.o = pos.o;
+                slots[i].publish(g.snap);
+            }
+            if (cfg.moveDelayMs > 0) this_thread::sleep_for(chrono::milliseconds(cfg.moveDelayMs));
+        }
+    };
+
+    vector<thread> pool;
+    for (int t = 0; t < cfg.threads; t++) pool.emplace_back(player, t);
+
+    int columns, lines;
+    terminalSize(columns, lines);
+    int perRow = max(1, columns / ARENA_TILE_WIDTH);
+    int visibleRows = max(1, (lines - ARENA_FIRST_LINE) / ARENA_TILE_HEIGHT);
+    int shown = min(cfg.games, perRow * visibleRows);
+    int tileRows = (shown + perRow - 1) / perRow;
+
+    vector<uint32_t> drawnVersion(cfg.games, UINT32_MAX);
+    string frame;
+    frame.reserve(64 * 1024);
+    auto interval = chrono::microseconds(1000000 / max(cfg.fps, 1));
+    TimePoint start = chrono::steady_clock::now();
+    TimePoint end = start + chrono::seconds(cfg.durationSec);
+    TimePoint nextFrame = start;
+    TimePoint rateMark = start;
+    uint64_t rateNodes = 0;
+    double nodeRate = 0;
+    uint64_t frames = 0;
+
+    frame = CLEAR_SCREEN;
+    frame += "\033[?25l"; // Hide the cursor while tiles are redrawn
+    while (chrono::steady_clock::now() < end) {
+        TimePoint now = chrono::steady_clock::now();
+        double sinceMark = chrono::duration<double>(now - rateMark).count();
+        if (sinceMark >= 1.0) {
+            uint64_t n = totalNodes.load(memory_order_relaxed);
+            nodeRate = (n - rateNodes) / sinceMark;
+            rateNodes = n;
+            rateMark = now;
+        }
+
+        appendCursor(frame, 1, 1);
+        frame += "\033[2K ARENA  ";
+        frame += DIFFICULTY_PROFILES[cfg.level].name;
+        frame += cfg.isScoreAttack ? " score attack  " : " classic  ";
+        frame += to_string(cfg.games) + " games";
+        if (shown < cfg.games) frame += " (" + to_string(shown) + " shown)";
+        frame += "  finished X " + to_string(xWins.load()) + " / O " + to_string(oWins.load()) + " / = " + to_string(draws.load());
+        frame += "  " + formatRate(nodeRate) + " nodes/s  " + to_string(cfg.fps) + " fps";
+
+        for (int i = 0; i < shown; i++) {
+            ArenaSnapshot snap;
+            uint32_t version;
+            if (!slots[i].read(snap, version) || version == drawnVersion[i]) continue;
+            drawnVersion[i] = version;
+            appendArenaTile(frame, i, snap, ARENA_FIRST_LINE + (i / perRow) * ARENA_TILE_HEIGHT, 1 + (i % perRow) * ARENA_TILE_WIDTH);
+        }
+        writeToTerminal(frame);
+        frame.clear();
+        frames++;
+
+        exportLatencyIfRequested();
+        nextFrame += interval;
+        if (nextFrame < chrono::steady_clock::now()) nextFrame = chrono::steady_clock::now(); // Fell behind: don't burst
+        this_thread::sleep_until(min(nextFrame, end));
+    }
+
+    stopping = true;
+    for (auto& t : pool) t.join();
+
+    double wallSec = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    frame.clear();
+    appendCursor(frame, ARENA_FIRST_LINE + tileRows * ARENA_TILE_HEIGHT, 1);
+    frame += "\033[J\033[?25h";
+    writeToTerminal(frame);
+    cout << " Arena: " << cfg.games << " games on " << cfg.threads << " threads"
+         << (cfg.searchThreads > 1 ? " (" + to_string(cfg.searchThreads) + " search threads each)" : "") << ", " << wallSec << " s, "
+         << (frames / wallSec) << " frames/s\n";
+    cout << "  Finished: X " << xWins.load() << "  O " << oWins.load() << "  draws " << draws.load()
+         << "  (" << formatRate(totalNodes.load() / wallSec) << " nodes/s overall)\n";
+}
+
+// --- HARDWARE COUNTERS ---
+// Optional (--perf): Linux perf_event counters around each search, read
+// straight from the kernel with no external tools. Counters follow the
+// calling thread and the search threads it starts. Any counter the kernel
+// refuses (permissions, VMs, other OSes) is simply reported as n/a.
+
+const int PERF_EVENT_COUNT = 5;
+const string PERF_EVENT_NAMES[PERF_EVENT_COUNT] = {"cycles", "instructions", "L1d misses", "LLC misses", "branch misses"};
+
+struct PerfSample {
+    uint64_t values[PERF_EVENT_COUNT] = {0, 0, 0, 0, 0};
+    bool valid[PERF_EVENT_COUNT] = {false, false, false, false, false};
+
+    void add(const PerfSample& o) {
+        for (int i = 0; i < PERF_EVENT_COUNT; i++) {
+            values[i] += o.values[i];
+            valid[i] = valid[i] || o.valid[i];
+        }
+    }
+};
+
+struct PerfCounters {
+    int fds[PERF_EVENT_COUNT] = {-1, -1, -1, -1, -1};
+    uint64_t baseline[PERF_EVENT_COUNT][3] = {}; // Readings at start(): value, time enabled, time running
+    string unavailableReason;
+
+    bool anyOpen() const {
+        for (int fd : fds) if (fd >= 0) return true;
+        return false;
+    }
+
+    #ifdef __linux__
+        bool open() {
+            const uint32_t types[PERF_EVENT_COUNT] = {PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE,
+                                                      PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE};
+            const uint64_t configs[PERF_EVENT_COUNT] = {
+                PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+                PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+            for (int i = 0; i < PERF_EVENT_COUNT; i++) {
+                perf_event_attr attr;
+                memset(&attr, 0, sizeof(attr));
+                attr.size = sizeof(attr);
+                attr.type = types[i];
+                attr.config = configs[i];
+                attr.disabled = 1;
+                attr.inherit = 1;        // Include root-parallel search threads
+                attr.exclude_kernel = 1;
+                attr.exclude_hv = 1;
+                attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+                fds[i] = (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+                if (fds[i] < 0 && unavailableReason.empty()) unavailableReason = strerror(errno);
+            }
+            return anyOpen();
+        }
+
+        // PERF_EVENT_IOC_RESET does not clear what exited search threads already
+        // folded into an inherited counter, so samples are differences of readings
+        void start() {
+            for (int i = 0; i < PERF_EVENT_COUNT; i++) {
+                if (fds[i] < 0) continue;
+                if (read(fds[i], baseline[i], sizeof(baseline[i])) != (ssize_t)sizeof(baseline[i])) memset(baseline[i], 0, sizeof(baseline[i]));
+                ioctl(fds[i], PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+
+        // Counts since start(), scaled up if the kernel had to multiplex counters
+        PerfSample stop() {
+            PerfSample s;
+            for (int i = 0; i < PERF_EVENT_COUNT; i++) {
+                if (fds[i] < 0) continue;
+                ioctl(fds[i], PERF_EVENT_IOC_DISABLE, 0);
+                uint64_t data[3]; // value, time enabled, time running
+                if (read(fds[i], data, sizeof(data)) != (ssize_t)sizeof(data)) continue;
+                uint64_t value = data[0] - baseline[i][0], enabled = data[1] - baseline[i][1], running = data[2] - baseline[i][2];
+                if (running == 0) continue;
+                s.values[i] = (uint64_t)((double)value * enabled / running);
+                s.valid[i] = true;
+            }
+            return s;
+        }
+
+        ~PerfCounters() { for (int fd : fds) if (fd >= 0) close(fd); }
+    #else
+        bool open() { unavailableReason = "perf_event is Linux-only"; return false; }
+        void start() {}
+        PerfSample stop() { return PerfSample(); }
+    #endif
+};
+
+bool perfEnabled = false;   // --perf, and at least one counter opened
+PerfCounters perfCounters;
+
+// Per-node view of a sample: the layout work cares about misses per node, not totals
+string formatPerfSample(const PerfSample& s, uint64_t nodes) {
+    ostringstream out;
+    out.setf(ios::fixed);
+    out.precision(1);
+    double n = (double)max<uint64_t>(nodes, 1);
+    for (int i = 0; i < PERF_EVENT_COUNT; i++) {
+        out << (i ? "  " : "") << PERF_EVENT_NAMES[i] << "/node ";
+        if (s.valid[i]) out << s.values[i] / n; else out << "n/a";
+    }
+    if (s.valid[0] && s.valid[1] && s.values[0] > 0) out << "  IPC " << setprecision(2) << (double)s.values[1] / s.values[0];
+    return out.str();
+}
+
+// --- BENCHMARK ---
+
+// Plays a move string of 1-based columns ("4453") onto an empty board, X first.
+// Returns false if a move is illegal or the string contains anything else.
+bool setBoardFromMoves(char b[ROWS][COLS], const string& moves) {
+    for (int i = 0; i < ROWS; i++) for (int j = 0; j < COLS; j++) b[i][j] = ' ';
+    char current = 'X';
+    for (char ch : moves) {
+        int col = ch - '1';
+        if (col < 0 || col >= COLS) return false;
+        int row = getNextOpenRow(b, col);
+        if (row == -1) return false;
+        b[row][col] = current;
+        current = (current == 'X') ? 'O' : 'X';
+    }
+    return true;
+}
+
+char sideToMove(char b[ROWS][COLS]) {
+    int pieces = 0;
+    for (int i = 0; i < ROWS; i++) for (int j = 0; j < COLS; j++) if (b[i][j] != ' ') pieces++;
+    return (pieces % 2 == 0) ? 'X' : 'O';
+}
+
+// Fixed opening, middlegame and endgame positions
+const vector<string> BENCH_POSITIONS = {
+    "",
+    "44",
+    "4453",
+    "443322",
+    "4433525",
+    "3443553256",
+    "3246117513",
+    "515211441215",
+    "4175126651554121",
+    "53267556661477767544",
+    "117254263353411744443121",
+    "1137124514133621557726675473",
+};
+
+struct BenchResult {
+    uint64_t nodes = 0;
+    uint64_t evalCalls = 0;
+    uint64_t cacheProbes = 0;
+    uint64_t cacheHits = 0;
+    uint64_t ttProbes = 0, ttHotHits = 0, ttMainHits = 0;
+    double seconds = 0;              // Wall clock: what NPS is computed from
+    double cpuSeconds = 0;           // Process CPU time, summed over all search threads
+    uint64_t reproHash = FNV_OFFSET; // Positions, results and node traces, in bench order
+    PerfSample perf;
+};
+
+BenchResult runBenchPass(int depth, bool isScoreAttack, bool verbose) {
+    BenchResult total;
+    for (const string& moves : BENCH_POSITIONS) {
+        char b[ROWS][COLS];
+        setBoardFromMoves(b, moves);
+        clearMemo();
+        evalCache.clear();
+        searchStats = SearchStats();
+
+        bool maximizingPlayer = (sideToMove(b) == 'O');
+        if (perfEnabled) perfCounters.start();
+        clock_t cpuStart = clock();
+        auto start = chrono::steady_clock::now();
+        pair<int, int> result = parallelRootSearch(b, depth, maximizingPlayer, isScoreAttack, rootSearchThreads);
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        double cpuSeconds = (double)(clock() - cpuStart) / CLOCKS_PER_SEC;
+        PerfSample perf = perfEnabled ? perfCounters.stop() : PerfSample();
+        total.perf.add(perf);
+
+        if (verbose) {
+            cout << "  " << (moves.empty() ? "(empty)" : moves) << ": col " << result.first + 1
+                 << "  score " << result.second << "  nodes " << searchStats.nodes
+                 << "  evals " << searchStats.evalCalls << "\n";
+            if (perfEnabled) cout << "    " << formatPerfSample(perf, searchStats.nodes) << "\n";
+        }
+        total.nodes += searchStats.nodes;
+        total.evalCalls += searchStats.evalCalls;
+        total.cacheProbes += searchStats.evalCacheProbes;
+        total.cacheHits += searchStats.evalCacheHits;
+        total.ttProbes += searchStats.ttProbes;
+        total.ttHotHits += searchStats.ttHotHits;
+        total.ttMainHits += searchStats.ttMainHits;
+        total.seconds += seconds;
+        total.cpuSeconds += cpuSeconds;
+        uint64_t fields[5] = {getPositionKey(b), (uint64_t)result.first, (uint64_t)(int64_t)result.second,
+                              searchStats.nodes, searchStats.traceHash};
+        total.reproHash = fnv1a(total.reproHash, fields, sizeof(fields));
+    }
+    return total;
+}
+
+void printBenchSummary(const string& label, const BenchResult& r) {
+    cout << " " << label << ": nodes " << r.nodes << "  evaluateBoard calls " << r.evalCalls
+         << "  time " << r.seconds << "s  nps " << (uint64_t)(r.nodes / max(r.seconds, 1e-9)) << "  cpu " << r.cpuSeconds << "s";
+    if (r.cacheProbes > 0) cout << "  eval cache hit rate " << (100.0 * r.cacheHits / r.cacheProbes) << "%";
+    cout << "\n";
+    if (r.ttProbes > 0) {
+        cout << "   TT: " << r.ttProbes << " probes, hits served by hot tier " << r.ttHotHits
+             << " (" << (100.0 * r.ttHotHits / r.ttProbes) << "%), main tier " << r.ttMainHits
+             << " (" << (100.0 * r.ttMainHits / r.ttProbes) << "%)\n";
+    }
+    if (perfEnabled) cout << "   " << formatPerfSample(r.perf, r.nodes) << "\n";
+}
+
+// Searches every bench position with the eval cache off and then on, so the
+// saved evaluateBoard calls are measured on identical trees.
+void runBench(int depth, bool isScoreAttack, int evalCacheMb) {
+    cout << " Bench: " << BENCH_POSITIONS.size() << " positions, depth " << depth
+         << (isScoreAttack ? ", score attack" : ", classic") << ", kernels " << cpuKernelVariant() << "\n";
+
+    evalCache.resize(0);
+    BenchResult uncached = runBenchPass(depth, isScoreAttack, false);
+    evalCache.resize(evalCacheMb);
+    BenchResult cached = runBenchPass(depth, isScoreAttack, true);
+
+    printBenchSummary("no eval cache", uncached);
+    if (evalCache.enabled()) {
+        printBenchSummary("eval cache (" + to_string(evalCacheMb) + " MB)", cached);
+        cout << " evaluateBoard calls reduced by "
+             << (100.0 - 100.0 * cached.evalCalls / max<uint64_t>(uncached.evalCalls, 1)) << "%\n";
+    }
+    if (deterministicMode) {
+        // The eval cache changes how often evaluateBoard runs, never what the search visits
+        cout << " Reproducibility hash: " << hex << cached.reproHash << dec
+             << (cached.reproHash == uncached.reproHash ? "" : "  (MISMATCH between passes!)") << "\n";
+    }
+}
+
+// Deepest iteration that completes within the budget (memo kept between
+// iterations, as in a real iterative-deepening search).
+int deepestDepthWithin(char b[ROWS][COLS], const SearchBudget& budget, bool isScoreAttack) {
+    clearMemo();
+    bool maximizingPlayer = (sideToMove(b) == 'O');
+    searchStats = SearchStats();
+    searchLimits = limitsFor(budget);
+    searchAborted = false;
+    int completed = 0;
+    for (int depth = 1; depth <= ROWS * COLS; depth++) {
+        minimax(b, depth, INT_MIN, INT_MAX, maximizingPlayer, isScoreAttack, depth);
+        if (searchAborted) break;
+        completed = depth;
+    }
+    searchLimits = SearchLimits();
+    searchAborted = false;
+    return completed;
+}
+
+// Average effective depth over the bench positions, baseline vs configured tuning.
+void runEffectiveDepthBench(const SearchBudget& budget, bool isScoreAttack) {
+    SearchTuning tuned = searchTuning;
+    SearchTuning baseline = tuned;
+    baseline.lateMoveReductions = false;
+    baseline.futilityPruning = false;
+    baseline.nonLosingMoves = false;
+
+    double depthSum[2] = {0, 0};
+    for (const string& moves : BENCH_POSITIONS) {
+        char b[ROWS][COLS];
+        setBoardFromMoves(b, moves);
+        searchTuning = baseline;
+        depthSum[0] += deepestDepthWithin(b, budget, isScoreAttack);
+        searchTuning = tuned;
+        depthSum[1] += deepestDepthWithin(b, budget, isScoreAttack);
+    }
+    cout << " Effective depth at " << (budget.nodes ? to_string(budget.nodes) + " nodes" : to_string(budget.timeMs) + " ms")
+         << "/position: baseline "
+         << depthSum[0] / BENCH_POSITIONS.size() << ", tuned " << depthSum[1] / BENCH_POSITIONS.size() << "\n";
+}
+
+// Per-level cost of one AI move over the bench positions: the node budget
+// should bound both the mean and the worst case.
+void runLevelBench(bool isScoreAttack) {
+    for (const DifficultyProfile& profile : DIFFICULTY_PROFILES) {
+        mt19937 rng(0);
+        uint64_t maxNodes = 0, totalNodes = 0;
+        double maxMs = 0, totalMs = 0;
+        for (const string& moves : BENCH_POSITIONS) {
+            char b[ROWS][COLS];
+            setBoardFromMoves(b, moves);
+            clearMemo();
+            searchStats = SearchStats();
+            auto start = chrono::steady_clock::now();
+            findAIMoveForProfile(b, sideToMove(b), profile, isScoreAttack, rng);
+            double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+            maxNodes = max(maxNodes, searchStats.nodes);
+            totalNodes += searchStats.nodes;
+            maxMs = max(maxMs, ms);
+            totalMs += ms;
         }
+        size_t n = BENCH_POSITIONS.size();
+        cout << " " << profile.name << ": budget " << profile.budget.nodes << " nodes | mean "
+             << totalNodes / n << " nodes, " << totalMs / n << " ms | max " << maxNodes << " nodes, " << maxMs << " ms\n";
     }
+}
 
-    if (memo.size() < MAX_MEMORY_SIZE) memo[key] = {bestCol, bestScore};
-    else memo.clear(); 
+// --- ENGINE SERVICE ---
+// The engine.h API: requests wait in a FIFO queue and each worker thread
+// searches one at a time. Workers keep their own memo table between
+// requests, like the interactive AI did between moves.
 
-    return {bestCol, bestScore};
+struct MoveJob {
+    MoveRequest request;
+    promise<MoveResult> result;
+    shared_ptr<atomic<bool>> cancelFlag;
+    chrono::steady_clock::time_point submitted;
+};
+
+struct Engine::Impl {
+    mutex lock;
+    condition_variable ready;
+    deque<MoveJob> queue;
+    vector<shared_ptr<atomic<bool>>> running; // Cancel flags of requests being searched
+    bool stopping = false;
+    int searchThreads = 1;
+    vector<thread> workers;
+};
+
+double msSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
 }
 
-int calculateFinalScore(char player) {
-    int score = 0;
-    // Horizontal
-    for (int r = 0; r < ROWS; r++) { 
-        int streak = 0; 
-        for (int c = 0; c < COLS; c++) { 
-            if (board[r][c] == player) streak++; 
-            else { 
-                if (streak >= 4) score += (streak - 3); 
-                streak = 0; 
-            } 
-        } 
-        if (streak >= 4) score += (streak - 3);
+MoveResult searchMoveRequest(const MoveRequest& req, atomic<bool>& cancel, chrono::steady_clock::time_point submitted) {
+    MoveResult res;
+    res.queuedMs = msSince(submitted);
+    if (cancel.load()) { res.status = MOVE_CANCELLED; return res; }
+
+    int remainingMs = 0;
+    if (req.deadline.count() > 0) {
+        remainingMs = (int)(req.deadline.count() - (int64_t)res.queuedMs);
+        if (remainingMs <= 0) { res.status = MOVE_EXPIRED; return res; }
+    }
+    char b[ROWS][COLS];
+    if (!setBoardFromMoves(b, req.moves) || checkWin(b, 'X') || checkWin(b, 'O') ||
+        (int)req.moves.size() == ROWS * COLS) {
+        return res; // MOVE_INVALID
+    }
+
+    auto start = chrono::steady_clock::now();
+    char piece = sideToMove(b);
+    searchStats = SearchStats();
+    if (req.depth > 0) {
+        SearchBudget budget;
+        budget.timeMs = remainingMs;
+        budget.maxDepth = req.depth;
+        budget.stop = &cancel;
+        res.column = findAIMoveWithin(b, piece, budget, req.scoreAttack);
+    } else {
+        int level = max(1, min(req.level, (int)DIFFICULTY_PROFILES.size())) - 1;
+        DifficultyProfile profile = DIFFICULTY_PROFILES[level];
+        if (remainingMs > 0) profile.budget.timeMs = min(profile.budget.timeMs, remainingMs);
+        profile.budget.stop = &cancel;
+        mt19937 rng((unsigned int)req.seed);
+        int phase = gamePhase(b);
+        res.column = findAIMoveForProfile(b, piece, profile, req.scoreAttack, rng);
+        latencyRegistry.record(level, phase, req.scoreAttack, (uint64_t)(msSince(start) * 1000));
+    }
+    res.searchMs = msSince(start);
+    res.status = cancel.load() ? MOVE_CANCELLED : MOVE_DONE;
+    res.score = searchStats.rootScore;
+    res.scored = searchStats.rootScored;
+    res.nodes = searchStats.nodes;
+    res.searchHash = searchStats.traceHash;
+    return res;
+}
+
+void Engine::workerLoop() {
+    rootSearchThreads = impl->searchThreads;
+    while (true) {
+        MoveJob job;
+        {
+            unique_lock<mutex> guard(impl->lock);
+            impl->ready.wait(guard, [&] { return impl->stopping || !impl->queue.empty(); });
+            if (impl->queue.empty()) return; // Stopping, and nothing left to complete
+            job = move(impl->queue.front());
+            impl->queue.pop_front();
+            impl->running.push_back(job.cancelFlag);
+        }
+        MoveResult res = searchMoveRequest(job.request, *job.cancelFlag, job.submitted);
+        {
+            lock_guard<mutex> guard(impl->lock);
+            impl->running.erase(find(impl->running.begin(), impl->running.end(), job.cancelFlag));
+        }
+        job.result.set_value(res);
+        if (job.request.onComplete) job.request.onComplete(res);
+    }
+}
+
+Engine::Engine(int workers, int searchThreads) : impl(new Impl()) {
+    if (workers <= 0) workers = max(1u, thread::hardware_concurrency());
+    impl->searchThreads = deterministicMode ? 1 : max(1, searchThreads);
+    for (int i = 0; i < workers; i++) impl->workers.emplace_back(&Engine::workerLoop, this);
+}
+
+Engine::~Engine() {
+    {
+        lock_guard<mutex> guard(impl->lock);
+        impl->stopping = true;
+        for (auto& job : impl->queue) job.cancelFlag->store(true); // Completed as cancelled, not dropped
+        for (auto& flag : impl->running) flag->store(true);
+    }
+    impl->ready.notify_all();
+    for (auto& t : impl->workers) t.join();
+}
+
+PendingMove Engine::requestMove(MoveRequest request) {
+    MoveJob job;
+    job.request = move(request);
+    job.cancelFlag = make_shared<atomic<bool>>(false);
+    job.submitted = chrono::steady_clock::now();
+    PendingMove pending;
+    pending.result = job.result.get_future();
+    pending.cancelFlag = job.cancelFlag;
+    {
+        lock_guard<mutex> guard(impl->lock);
+        impl->queue.push_back(move(job));
+    }
+    impl->ready.notify_one();
+    return pending;
+}
+
+int Engine::workerCount() const {
+    return (int)impl->workers.size();
+}
+
+// --- C API ---
+// connect4.h for other languages. Each context holds a position; searches run
+// on the calling thread with its memo table. No exception crosses the ABI.
+
+struct c4_engine {
+    char b[ROWS][COLS];
+};
+
+bool gameIsOver(char b[ROWS][COLS]) {
+    return checkWin(b, 'X') || checkWin(b, 'O') || firstLegalColumn(b) == -1;
+}
+
+// 'O' maximizes inside the engine; callers get the side to move's view
+int sideToMoveScore(char b[ROWS][COLS], int score) {
+    return sideToMove(b) == 'O' ? score : -score;
+}
+
+// evaluateBoard is not antisymmetric (the opponent's threats weigh differently),
+// so C API searches score each leaf for its side to move like a depth-0 batch
+// call does, and only reuse entries of the depth asked for: a depth-d score is
+// then negamax over depth-0 scores, whatever the context searched before
+struct ApiSearchScoring {
+    SearchTuning saved = searchTuning;
+    ApiSearchScoring() {
+        searchTuning.sideToMoveLeaves = true;
+        searchTuning.exactDepthOnly = true;
+    }
+    ~ApiSearchScoring() { searchTuning = saved; }
+};
+
+extern "C" {
+
+int32_t c4_api_version(void) {
+    return C4_API_VERSION;
+}
+
+int32_t c4_attach_shared_table(const char* name, int32_t tt_mb) {
+    if (!name || !*name || tt_mb <= 0) return C4_INVALID_ARGUMENT;
+    try {
+        string error;
+        return attachSharedTable(name, tt_mb, hotTableKb, error) ? C4_OK : C4_INVALID_ARGUMENT;
+    } catch (...) {
+        return C4_INVALID_ARGUMENT;
+    }
+}
+
+c4_engine* c4_create(void) {
+    try {
+        c4_engine* engine = new c4_engine();
+        setBoardFromMoves(engine->b, "");
+        return engine;
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void c4_destroy(c4_engine* engine) {
+    delete engine;
+}
+
+int32_t c4_set_position(c4_engine* engine, const char* moves) {
+    if (!engine || !moves) return C4_INVALID_ARGUMENT;
+    char b[ROWS][COLS];
+    if (!setBoardFromMoves(b, moves)) return C4_INVALID_MOVES;
+    memcpy(engine->b, b, sizeof(b));
+    return C4_OK;
+}
+
+int32_t c4_search(c4_engine* engine, const c4_limits* limits, c4_search_result* result) {
+    if (!engine || !limits || !result) return C4_INVALID_ARGUMENT;
+    if (limits->depth <= 0 && limits->time_ms <= 0 && limits->nodes == 0) return C4_INVALID_ARGUMENT;
+    if (gameIsOver(engine->b)) return C4_GAME_OVER;
+    try {
+        ApiSearchScoring scoring;
+        SearchBudget budget;
+        budget.timeMs = max(0, (int)limits->time_ms);
+        budget.nodes = limits->nodes;
+        if (limits->depth > 0) budget.maxDepth = limits->depth;
+        auto start = chrono::steady_clock::now();
+        searchStats = SearchStats();
+        result->column = findAIMoveWithin(engine->b, sideToMove(engine->b), budget, limits->score_attack != 0);
+        result->score = searchStats.rootScored ? sideToMoveScore(engine->b, searchStats.rootScore) : 0;
+        result->depth = searchStats.completedDepth;
+        result->nodes = searchStats.nodes;
+        result->ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        return C4_OK;
+    } catch (...) {
+        return C4_INVALID_ARGUMENT;
+    }
+}
+
+int32_t c4_evaluate_batch(c4_engine* engine, const char* const* moves, size_t count, int32_t depth,
+                          int32_t score_attack, int32_t* scores, int32_t* statuses) {
+    if (!engine || (count > 0 && (!moves || !scores || !statuses)) || depth < 0) return C4_INVALID_ARGUMENT;
+    try {
+        ApiSearchScoring scoring;
+        newSearchGeneration();
+        char b[ROWS][COLS];
+        vector<uint64_t> own, opp;  // depth 0: positions gathered for evaluateBatch
+        vector<size_t> slots;
+        for (size_t i = 0; i < count; i++) {
+            scores[i] = 0;
+            if (!moves[i] || !setBoardFromMoves(b, moves[i])) { statuses[i] = C4_INVALID_MOVES; continue; }
+            if (gameIsOver(b)) { statuses[i] = C4_GAME_OVER; continue; }
+            char piece = sideToMove(b);
+            if (depth == 0) {
+                BitPosition bits = toBitPosition(b);
+                own.push_back(piece == 'O' ? bits.o : bits.x);
+                opp.push_back(piece == 'O' ? bits.x : bits.o);
+                slots.push_back(i);
+            } else {
+                int score = parallelRootSearch(b, depth, piece == 'O', score_attack != 0, rootSearchThreads).second;
+                scores[i] = sideToMoveScore(b, score);
+            }
+            statuses[i] = C4_OK;
+        }
+        if (!slots.empty()) {
+            vector<int32_t> batch(slots.size());
+            evaluateBatch(own.data(), opp.data(), slots.size(), batch.data());
+            for (size_t k = 0; k < slots.size(); k++) scores[slots[k]] = batch[k];
+        }
+        return C4_OK;
+    } catch (...) {
+        return C4_INVALID_ARGUMENT;
+    }
+}
+
+} // extern "C"
+
+// --- DISTRIBUTED SOLVER ---
+// Exact solving spread over worker processes on this or other machines. The
+// coordinator expands the position to every line of --split-depth moves,
+// hands those positions out one at a time to the workers that connect, and
+// backs the exact scores up the split tree (negamax). A worker holds one job
+// at a time; if it disconnects, its job goes back to the queue.
+//
+// Protocol: one text line per message over a stream socket (Unix or TCP)
+//   worker -> coordinator   HELLO | RESULT <job> <score> <nodes>
+//   coordinator -> worker   SOLVE <job> <moves> | DONE
+// Addresses: "unix:/path" (or any path starting with '/') and "host:port".
+
+const int DEFAULT_COORDINATOR_TIMEOUT_SEC = 600; // --coordinator-timeout: gives up with no worker connected
+
+struct DistributedSolveResult {
+    bool ok = false;
+    string error;
+    int score = 0;          // As Solver::solve, for the side to move
+    int bestColumn = -1;    // 0-based
+    int moveScores[COLS];   // Side to move's score after each root move (INT_MIN: not playable)
+    size_t jobs = 0;        // Positions solved by workers
+    uint64_t nodes = 0;     // Summed over all workers
+    int workers = 0;        // Connections that returned at least one result
+    int requeued = 0;       // Jobs handed out again after a worker left
+};
+
+struct SplitNode {
+    string moves;
+    int value = 0;          // Known (leaf decided here or solved by a worker) once 'known'
+    bool known = false;
+    int job = -1;           // Index into the job list, or -1
+    int children[COLS];
+};
+
+// Expands 'p' (reached by 'moves') to 'depth' more plies. Positions decided
+// without a search (immediate win, full board) are leaves with known values.
+int buildSplitTree(vector<SplitNode>& nodes, vector<int>& jobs, const SolverPosition& p, const string& moves, int depth) {
+    int index = (int)nodes.size();
+    nodes.push_back(SplitNode());
+    nodes[index].moves = moves;
+    for (int c = 0; c < COLS; c++) nodes[index].children[c] = -1;
+    if (p.moves == ROWS * COLS) { nodes[index].known = true; return index; } // Draw
+    if (p.canWinNext()) {
+        nodes[index].value = (ROWS * COLS + 1 - p.moves) / 2;
+        nodes[index].known = true;
+        return index;
+    }
+    if (depth == 0) {
+        nodes[index].job = (int)jobs.size();
+        jobs.push_back(index);
+        return index;
     }
-    // Vertical
     for (int c = 0; c < COLS; c++) {
-        int streak = 0; 
-        for (int r = 0; r < ROWS; r++) { 
-            if (board[r][c] == player) streak++; 
-            else { 
-                if (streak >= 4) score += (streak - 3); 
-                streak = 0; 
-            } 
-        } 
-        if (streak >= 4) score += (streak - 3);
+        if (!p.canPlay(c)) continue;
+        SolverPosition child = p;
+        child.play((p.mask + (1ULL << (c * COL_BITS))) & columnMask(c));
+        int childIndex = buildSplitTree(nodes, jobs, child, moves + char('1' + c), depth - 1);
+        nodes[index].children[c] = childIndex;
     }
-    // Diagonal (Down-Right)
-    for (int r = 0; r < ROWS - 3; r++) {
-        for (int c = 0; c < COLS - 3; c++) {
-            if (board[r][c] == player && board[r+1][c+1] == player && board[r+2][c+2] == player && board[r+3][c+3] == player) { 
-                score++; 
+    return index;
+}
+
+int backUpSplitTree(vector<SplitNode>& nodes, int index) {
+    SplitNode& n = nodes[index];
+    if (n.known) return n.value;
+    int best = INT_MIN;
+    for (int c = 0; c < COLS; c++)
+        if (n.children[c] >= 0) best = max(best, -backUpSplitTree(nodes, n.children[c]));
+    n.value = best;
+    n.known = true;
+    return best;
+}
+
+#ifndef _WIN32
+#ifdef MSG_NOSIGNAL
+const int SEND_FLAGS = MSG_NOSIGNAL; // A worker that vanished must not kill the coordinator
+#else
+const int SEND_FLAGS = 0;
+#endif
+
+bool isUnixAddress(const string& address) {
+    return address.rfind("unix:", 0) == 0 || (!address.empty() && address[0] == '/');
+}
+
+string unixPath(const string& address) {
+    return address.rfind("unix:", 0) == 0 ? address.substr(5) : address;
+}
+
+bool fillUnixAddress(const string& address, sockaddr_un& sa, string& error) {
+    string path = unixPath(address);
+    if (path.size() >= sizeof(sa.sun_path)) { error = "socket path too long: " + path; return false; }
+    memset(&sa, 0, sizeof(sa));
+    sa.sun_family = AF_UNIX;
+    memcpy(sa.sun_path, path.c_str(), path.size() + 1);
+    return true;
+}
+
+addrinfo* resolveTcp(const string& address, bool passive, string& error) {
+    size_t colon = address.rfind(':');
+    if (colon == string::npos) { error = "expected host:port or unix:/path, got " + address; return nullptr; }
+    string host = address.substr(0, colon), port = address.substr(colon + 1);
+    addrinfo hints, *found = nullptr;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    if (passive) hints.ai_flags = AI_PASSIVE;
+    int rc = getaddrinfo(host.empty() || host == "*" ? nullptr : host.c_str(), port.c_str(), &hints, &found);
+    if (rc != 0) { error = string("getaddrinfo: ") + gai_strerror(rc); return nullptr; }
+    return found;
+}
+
+// Listening socket; 'bound' is the address workers should use (a TCP port 0 becomes the real port)
+int listenOn(const string& address, string& bound, string& error) {
+    bound = address;
+    if (isUnixAddress(address)) {
+        sockaddr_un sa;
+        if (!fillUnixAddress(address, sa, error)) return -1;
+        unlink(sa.sun_path); // A socket file left by an earlier run
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0 || ::bind(fd, (sockaddr*)&sa, sizeof(sa)) != 0 || listen(fd, 64) != 0) {
+            error = string("listen on ") + sa.sun_path + ": " + strerror(errno);
+            if (fd >= 0) close(fd);
+            return -1;
+        }
+        return fd;
+    }
+    addrinfo* found = resolveTcp(address, true, error);
+    if (!found) return -1;
+    int fd = -1;
+    for (addrinfo* a = found; a && fd < 0; a = a->ai_next) {
+        fd = socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+        if (fd < 0) continue;
+        int on = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+        if (::bind(fd, a->ai_addr, a->ai_addrlen) != 0 || listen(fd, 64) != 0) { close(fd); fd = -1; }
+    }
+    freeaddrinfo(found);
+    if (fd < 0) { error = "listen on " + address + ": " + strerror(errno); return -1; }
+    sockaddr_storage local;
+    socklen_t length = sizeof(local);
+    if (getsockname(fd, (sockaddr*)&local, &length) == 0) {
+        int port = local.ss_family == AF_INET6 ? ntohs(((sockaddr_in6*)&local)->sin6_port) : ntohs(((sockaddr_in*)&local)->sin_port);
+        string host = address.substr(0, address.rfind(':'));
+        bound = (host.empty() || host == "*" || host == "0.0.0.0" ? "127.0.0.1" : host) + ":" + to_string(port);
+    }
+    return fd;
+}
+
+// Retries for up to 'waitMs', so workers may start before their coordinator
+int connectTo(const string& address, int waitMs, string& error) {
+    auto until = chrono::steady_clock::now() + chrono::milliseconds(waitMs);
+    while (true) {
+        int fd = -1;
+        if (isUnixAddress(address)) {
+            sockaddr_un sa;
+            if (!fillUnixAddress(address, sa, error)) return -1;
+            fd = socket(AF_UNIX, SOCK_STREAM, 0);
+            if (fd >= 0 && connect(fd, (sockaddr*)&sa, sizeof(sa)) != 0) { close(fd); fd = -1; }
+        } else {
+            addrinfo* found = resolveTcp(address, false, error);
+            if (!found) return -1;
+            for (addrinfo* a = found; a && fd < 0; a = a->ai_next) {
+                fd = socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+                if (fd >= 0 && connect(fd, a->ai_addr, a->ai_addrlen) != 0) { close(fd); fd = -1; }
             }
+            freeaddrinfo(found);
         }
+        if (fd >= 0) return fd;
+        if (chrono::steady_clock::now() >= until) { error = "connect to " + address + ": " + strerror(errno); return -1; }
+        this_thread::sleep_for(chrono::milliseconds(100));
     }
-    // Diagonal (Up-Right)
-    for (int r = 3; r < ROWS; r++) {
-        for (int c = 0; c < COLS - 3; c++) {
-            if (board[r][c] == player && board[r-1][c+1] == player && board[r-2][c+2] == player && board[r-3][c+3] == player) { 
-                score++; 
+}
+
+bool sendLine(int fd, const string& line) {
+    string data = line + "\n";
+    size_t done = 0;
+    while (done < data.size()) {
+        ssize_t n = send(fd, data.data() + done, data.size() - done, SEND_FLAGS);
+        if (n <= 0) return false;
+        done += (size_t)n;
+    }
+    return true;
+}
+
+// Next complete line from 'fd' (blocking); false on EOF or error
+bool readLine(int fd, string& buffer, string& line) {
+    while (true) {
+        size_t end = buffer.find('\n');
+        if (end != string::npos) {
+            line = buffer.substr(0, end);
+            buffer.erase(0, end + 1);
+            return true;
+        }
+        char chunk[4096];
+        ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+        if (n <= 0) return false;
+        buffer.append(chunk, (size_t)n);
+    }
+}
+
+// Serves one coordinator until it says DONE. Returns the number of jobs solved, -1 on error.
+int runSolveWorker(const string& address, int solverMb, int connectWaitMs, string& error) {
+    int fd = connectTo(address, connectWaitMs, error);
+    if (fd < 0) return -1;
+    unique_ptr<Solver> table; // Kept between jobs: its entries are exact bounds of positions, valid for any job
+    try {
+        table.reset(new Solver(solverMb));
+    } catch (const exception& e) {
+        error = "cannot allocate a " + to_string(solverMb) + " MB solver table (" + e.what() + ")";
+        close(fd);
+        return -1;
+    }
+    Solver& solver = *table;
+    string buffer, line;
+    int solved = 0;
+    bool ok = sendLine(fd, "HELLO");
+    while (ok && readLine(fd, buffer, line)) {
+        istringstream in(line);
+        string command, moves;
+        int job = -1;
+        in >> command >> job >> moves;
+        if (command == "DONE") { close(fd); return solved; }
+        char b[ROWS][COLS];
+        if (command != "SOLVE" || job < 0 || !setBoardFromMoves(b, moves)) { error = "bad request: " + line; break; }
+        uint64_t before = solver.nodes;
+        int score = solver.solve(toSolverPosition(b));
+        ok = sendLine(fd, "RESULT " + to_string(job) + " " + to_string(score) + " " + to_string(solver.nodes - before));
+        solved++;
+    }
+    if (error.empty()) error = "coordinator closed the connection";
+    close(fd);
+    return -1;
+}
+
+struct WorkerConnection {
+    int fd;
+    string buffer;
+    int job = -1;        // In flight, or -1 when idle
+    bool helloed = false;
+    bool returned = false; // Has sent a result
+};
+
+// Coordinator: splits 'moves' and waits for workers on 'address' until every
+// job is solved. 'localWorkers' worker processes are forked on this machine
+// first; remote ones can connect at any time. It gives up once every forked
+// worker has exited with nobody connected, or after 'idleTimeoutSec' seconds
+// without any connected worker (0 waits forever).
+DistributedSolveResult solveDistributed(const string& moves, const string& address, int splitDepth, int localWorkers,
+                                        int solverMb = DEFAULT_SOLVER_TABLE_MB, bool progress = false,
+                                        int idleTimeoutSec = DEFAULT_COORDINATOR_TIMEOUT_SEC) {
+    DistributedSolveResult result;
+    for (int c = 0; c < COLS; c++) result.moveScores[c] = INT_MIN;
+    char b[ROWS][COLS];
+    if (!setBoardFromMoves(b, moves)) { result.error = "invalid move sequence: " + moves; return result; }
+    if (checkWin(b, 'X') || checkWin(b, 'O')) { result.error = "the game is already over"; return result; }
+    SolverPosition root = toSolverPosition(b);
+    if (root.moves == ROWS * COLS) { result.error = "the board is full"; return result; }
+
+    // The root is always split at least once, so every root move gets its own score
+    vector<SplitNode> tree;
+    vector<int> jobs;
+    buildSplitTree(tree, jobs, root, moves, max(1, splitDepth));
+    vector<int> solved(jobs.size(), 0);
+    size_t remaining = jobs.size();
+    deque<int> queue;
+    for (size_t j = 0; j < jobs.size(); j++) queue.push_back((int)j);
+
+    string bound;
+    int listener = listenOn(address, bound, result.error);
+    if (listener < 0) return result;
+    vector<pid_t> children;
+    for (int w = 0; w < localWorkers && remaining > 0; w++) {
+        cout.flush();
+        pid_t pid = fork();
+        if (pid == 0) {
+            close(listener);
+            string error;
+            _exit(runSolveWorker(bound, solverMb, 10000, error) < 0 ? 1 : 0);
+        }
+        if (pid > 0) children.push_back(pid);
+    }
+
+    vector<WorkerConnection> workers;
+    auto dispatch = [&](WorkerConnection& w) {
+        while (w.helloed && w.job < 0 && !queue.empty()) {
+            int job = queue.front();
+            queue.pop_front();
+            if (solved[job]) continue; // Answered by another worker after a requeue
+            w.job = job;
+            if (!sendLine(w.fd, "SOLVE " + to_string(job) + " " + tree[jobs[job]].moves)) break; // Requeued on hangup
+        }
+    };
+    auto drop = [&](size_t i) {
+        if (workers[i].job >= 0 && !solved[workers[i].job]) { queue.push_front(workers[i].job); result.requeued++; }
+        close(workers[i].fd);
+        workers.erase(workers.begin() + i);
+    };
+
+    auto lastReport = chrono::steady_clock::now();
+    auto lastConnected = lastReport;
+    int localExits = 0, lastExitStatus = 0;
+    while (remaining > 0) {
+        // Reap local workers that ended early (no coordinator, no memory, ...)
+        for (size_t c = children.size(); c-- > 0;) {
+            int status = 0;
+            if (waitpid(children[c], &status, WNOHANG) != children[c]) continue;
+            children.erase(children.begin() + c);
+            localExits++;
+            lastExitStatus = status;
+        }
+        if (!workers.empty()) lastConnected = chrono::steady_clock::now();
+        if (localExits > 0 && children.empty() && workers.empty()) {
+            result.error = "all " + to_string(localExits) + " local workers exited (last " +
+                           (WIFEXITED(lastExitStatus) ? "with status " + to_string(WEXITSTATUS(lastExitStatus))
+                                                      : "by signal " + to_string(WTERMSIG(lastExitStatus))) +
+                           ") and no worker is connected";
+            break;
+        }
+        if (idleTimeoutSec > 0 && chrono::steady_clock::now() - lastConnected > chrono::seconds(idleTimeoutSec)) {
+            result.error = "no worker connected for " + to_string(idleTimeoutSec) + " s";
+            break;
+        }
+
+        vector<pollfd> fds;
+        fds.push_back({listener, POLLIN, 0});
+        for (auto& w : workers) fds.push_back({w.fd, POLLIN, 0});
+        if (poll(fds.data(), fds.size(), 1000) < 0 && errno != EINTR) { result.error = strerror(errno); break; }
+
+        for (size_t i = workers.size(); i-- > 0;) {
+            short events = fds[i + 1].revents;
+            if (!events) continue;
+            char chunk[4096];
+            ssize_t n = (events & (POLLIN | POLLHUP | POLLERR)) ? recv(workers[i].fd, chunk, sizeof(chunk), 0) : 1;
+            if (n <= 0) { drop(i); continue; }
+            workers[i].buffer.append(chunk, (size_t)n);
+            size_t end;
+            bool bad = false;
+            while ((end = workers[i].buffer.find('\n')) != string::npos) {
+                istringstream in(workers[i].buffer.substr(0, end));
+                workers[i].buffer.erase(0, end + 1);
+                string command;
+                in >> command;
+                if (command == "HELLO") { workers[i].helloed = true; continue; }
+                int job = -1, score = 0;
+                uint64_t nodes = 0;
+                if (command != "RESULT" || !(in >> job >> score >> nodes) || job != workers[i].job) { bad = true; break; }
+                workers[i].job = -1;
+                if (!workers[i].returned) result.workers++;
+                workers[i].returned = true;
+                result.nodes += nodes;
+                if (!solved[job]) {
+                    solved[job] = 1;
+                    tree[jobs[job]].value = score;
+                    tree[jobs[job]].known = true;
+                    remaining--;
+                }
             }
+            if (bad) drop(i);
+        }
+        if (fds[0].revents & POLLIN) {
+            int fd = accept(listener, nullptr, nullptr);
+            if (fd >= 0) { WorkerConnection w; w.fd = fd; workers.push_back(w); }
+        }
+        for (auto& w : workers) dispatch(w);
+
+        if (progress && chrono::steady_clock::now() - lastReport > chrono::seconds(5)) {
+            lastReport = chrono::steady_clock::now();
+            cout << "  " << jobs.size() - remaining << " / " << jobs.size() << " jobs, " << workers.size() << " workers connected\n";
         }
     }
-    return score;
+
+    // Workers still waiting in the backlog are told too, rather than reset
+    fcntl(listener, F_SETFL, fcntl(listener, F_GETFL) | O_NONBLOCK);
+    for (int fd; (fd = accept(listener, nullptr, nullptr)) >= 0;) { WorkerConnection w; w.fd = fd; workers.push_back(w); }
+    for (auto& w : workers) {
+        sendLine(w.fd, "DONE");
+        close(w.fd);
+    }
+    close(listener);
+    if (isUnixAddress(address)) unlink(unixPath(address).c_str());
+    for (pid_t pid : children) waitpid(pid, nullptr, 0);
+    if (remaining > 0) return result;
+
+    result.ok = true;
+    result.jobs = jobs.size();
+    result.score = backUpSplitTree(tree, 0);
+    if (root.canWinNext()) { // Decided without workers: play the win
+        for (int c = 0; c < COLS && result.bestColumn < 0; c++)
+            if (root.ownWinningCells() & root.possible() & columnMask(c)) result.bestColumn = c;
+        result.moveScores[result.bestColumn] = result.score;
+    }
+    for (int c = 0; c < COLS; c++) {
+        if (tree[0].children[c] < 0) continue;
+        result.moveScores[c] = -tree[tree[0].children[c]].value;
+        if (result.bestColumn < 0 || result.moveScores[c] > result.moveScores[result.bestColumn]) result.bestColumn = c;
+    }
+    return result;
+}
+#else
+int runSolveWorker(const string&, int, int, string& error) {
+    error = "the distributed solver needs POSIX sockets";
+    return -1;
+}
+
+DistributedSolveResult solveDistributed(const string&, const string&, int, int, int = DEFAULT_SOLVER_TABLE_MB, bool = false,
+                                        int = DEFAULT_COORDINATOR_TIMEOUT_SEC) {
+    DistributedSolveResult result;
+    result.error = "the distributed solver needs POSIX sockets";
+    return result;
+}
+#endif
+
+// --- COMMAND LINE ---
+
+string getArgValue(int argc, char** argv, const string& name, const string& fallback) {
+    for (int i = 1; i + 1 < argc; i++) if (name == argv[i]) return argv[i + 1];
+    return fallback;
+}
+
+bool hasArg(int argc, char** argv, const string& name) {
+    for (int i = 1; i < argc; i++) if (name == argv[i]) return true;
+    return false;
+}
+
+void printUsage() {
+    cout << " Usage: connect4 [--bench | --solve MOVES [--coordinator ADDRESS] | --solve-worker ADDRESS |\n"
+         << "                  --match | --loadgen | --arena | --selfplay] [options]\n"
+         << "  Numeric options take whole numbers (--think-ms, --think-sigma and --temperature\n"
+         << "  also take decimals). See README.md for every mode and option.\n";
+}
+
+// Numeric option value, or 'fallback' when the option is absent. A value that
+// is missing, not a number of type T or out of its range prints the usage and
+// exits, instead of ending in an uncaught exception.
+template <typename T>
+T getNumberArg(int argc, char** argv, const string& name, T fallback) {
+    if (!hasArg(argc, argv, name)) return fallback;
+    string text = getArgValue(argc, argv, name, "");
+    istringstream in(text);
+    T value;
+    bool ok = !text.empty() && (is_signed<T>::value || text[0] != '-') && (in >> value) && in.peek() == EOF;
+    if (!ok) {
+        cout << " Invalid value for " << name << ": '" << text << "'\n";
+        printUsage();
+        exit(2);
+    }
+    return value;
+}
+
+// --lmr on|off, --lmr-moves N, --lmr-depth N, --lmr-reduction N, --futility on|off, --futility-margin N,
+// --non-losing on|off
+SearchTuning parseTuning(int argc, char** argv) {
+    SearchTuning t;
+    t.lateMoveReductions = getArgValue(argc, argv, "--lmr", t.lateMoveReductions ? "on" : "off") == "on";
+    t.lmrFullDepthMoves = getNumberArg<int>(argc, argv, "--lmr-moves", t.lmrFullDepthMoves);
+    t.lmrMinDepth = getNumberArg<int>(argc, argv, "--lmr-depth", t.lmrMinDepth);
+    t.lmrReduction = getNumberArg<int>(argc, argv, "--lmr-reduction", t.lmrReduction);
+    t.futilityPruning = getArgValue(argc, argv, "--futility", t.futilityPruning ? "on" : "off") == "on";
+    t.futilityMargin = getNumberArg<int>(argc, argv, "--futility-margin", t.futilityMargin);
+    t.nonLosingMoves = getArgValue(argc, argv, "--non-losing", t.nonLosingMoves ? "on" : "off") == "on";
+    return t;
+}
+
+// --movetime MS, --nodes N
+SearchBudget parseBudget(int argc, char** argv) {
+    SearchBudget budget;
+    budget.timeMs = getNumberArg<int>(argc, argv, "--movetime", 0);
+    budget.nodes = getNumberArg<uint64_t>(argc, argv, "--nodes", 0);
+    if (deterministicMode && budget.timeMs > 0 && budget.nodes == 0) {
+        cout << " Deterministic mode ignores --movetime; use --nodes for a reproducible budget.\n";
+    }
+    return budget;
+}
+
+// Seeds default to the clock, or to 0 in deterministic mode.
+unsigned int parseSeed(int argc, char** argv) {
+    unsigned int fallback = deterministicMode ? 0u : (unsigned int)time(nullptr);
+    return getNumberArg<unsigned int>(argc, argv, "--seed", fallback);
 }
 
 // --- INPUT UTILITY ---
@@ -407,15 +3897,186 @@ int getUserInput() {
 }
 
 // --- MAIN LOOP ---
+// Tools built from this file (bench/microbench.cpp) define CONNECT4_NO_MAIN and bring their own.
+#ifndef CONNECT4_NO_MAIN
 
-int main() {
+int main(int argc, char** argv) {
     setupConsole(); // WINDOWS FIX APPLIED HERE
 
+    int evalCacheMb = getNumberArg<int>(argc, argv, "--eval-cache-mb", DEFAULT_EVAL_CACHE_MB);
+    evalCache.resize(evalCacheMb);
+    configuredTuning = parseTuning(argc, argv);
+    searchTuning = configuredTuning;
+    deterministicMode = hasArg(argc, argv, "--deterministic");
+    // Root-parallel threads for the interactive AI and the bench (self-play and
+    // matches already run one game per thread, so their workers stay serial)
+    rootSearchThreads = max(1, getNumberArg<int>(argc, argv, "--search-threads", (int)max(1u, thread::hardware_concurrency())));
+    if (deterministicMode) rootSearchThreads = 1;
+    latencyExportPath = getArgValue(argc, argv, "--latency-out", "");
+    tableMb = getNumberArg<int>(argc, argv, "--tt-mb", DEFAULT_TT_MB);
+    hotTableKb = getNumberArg<int>(argc, argv, "--tt-hot-kb", DEFAULT_HOT_TT_KB);
+    renderer.diffMode = hasArg(argc, argv, "--diff-render");
+    if (hasArg(argc, argv, "--perf")) {
+        perfEnabled = perfCounters.open();
+        if (!perfEnabled) cout << " Hardware counters unavailable (" << perfCounters.unavailableReason << "), continuing without them.\n";
+    }
+    #ifdef SIGUSR1
+        signal(SIGUSR1, onLatencyExportSignal);
+    #endif
+    #ifdef SIGWINCH
+        signal(SIGWINCH, onTerminalResize);
+    #endif
+
+    if (hasArg(argc, argv, "--bench")) {
+        if (!deterministicMode) rootSearchThreads = max(1, getNumberArg<int>(argc, argv, "--search-threads", 1));
+        bool benchScoreAttack = hasArg(argc, argv, "--score-attack");
+        runBench(max(1, getNumberArg<int>(argc, argv, "--depth", 7)), benchScoreAttack, evalCacheMb);
+        SearchBudget budget = parseBudget(argc, argv);
+        if (budget.nodes > 0 || (budget.timeMs > 0 && !deterministicMode)) runEffectiveDepthBench(budget, benchScoreAttack);
+        if (hasArg(argc, argv, "--levels")) runLevelBench(benchScoreAttack);
+        return 0;
+    }
+
+    if (hasArg(argc, argv, "--solve-worker")) {
+        string address = getArgValue(argc, argv, "--solve-worker", "");
+        string error;
+        int solved = runSolveWorker(address, getNumberArg<int>(argc, argv, "--solver-mb", DEFAULT_SOLVER_TABLE_MB),
+                                    getNumberArg<int>(argc, argv, "--connect-wait", 30) * 1000, error);
+        if (solved < 0) { cout << " Worker stopped: " << error << "\n"; return 1; }
+        cout << " Worker done: " << solved << " positions solved for " << address << "\n";
+        return 0;
+    }
+
+    if (hasArg(argc, argv, "--solve") && hasArg(argc, argv, "--coordinator")) {
+        string moves = getArgValue(argc, argv, "--solve", "");
+        string address = getArgValue(argc, argv, "--coordinator", "");
+        int splitDepth = getNumberArg<int>(argc, argv, "--split-depth", 2);
+        int localWorkers = getNumberArg<int>(argc, argv, "--local-workers", 0);
+        cout << " Coordinating " << (moves.empty() ? "(empty)" : moves) << " on " << address << ", split depth " << splitDepth
+             << ", " << localWorkers << " local workers\n";
+        auto start = chrono::steady_clock::now();
+        DistributedSolveResult r = solveDistributed(moves, address, splitDepth, localWorkers,
+                                                    getNumberArg<int>(argc, argv, "--solver-mb", DEFAULT_SOLVER_TABLE_MB), true,
+                                                    getNumberArg<int>(argc, argv, "--coordinator-timeout", DEFAULT_COORDINATOR_TIMEOUT_SEC));
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        if (!r.ok) { cout << " Distributed solve failed: " << r.error << "\n"; return 1; }
+        char b[ROWS][COLS];
+        setBoardFromMoves(b, moves);
+        cout << " Position " << (moves.empty() ? "(empty)" : moves) << ": score " << r.score << " for " << sideToMove(b)
+             << ", best column " << r.bestColumn + 1 << " (" << r.jobs << " jobs on " << r.workers << " workers, "
+             << r.nodes << " nodes, " << ms << " ms" << (r.requeued ? ", " + to_string(r.requeued) + " requeued" : "") << ")\n";
+        cout << "  Move scores:";
+        for (int c = 0; c < COLS; c++)
+            cout << "  " << c + 1 << ":" << (r.moveScores[c] == INT_MIN ? string("-") : to_string(r.moveScores[c]));
+        cout << "\n";
+        return 0;
+    }
+
+    if (hasArg(argc, argv, "--solve")) {
+        string moves = getArgValue(argc, argv, "--solve", "");
+        char b[ROWS][COLS];
+        if (!setBoardFromMoves(b, moves)) { cout << " Invalid move sequence: " << moves << "\n"; return 1; }
+        if (checkWin(b, 'X') || checkWin(b, 'O')) { cout << " The game is already over.\n"; return 1; }
+        Solver solver;
+        if (perfEnabled) perfCounters.start();
+        auto start = chrono::steady_clock::now();
+        int score = solver.solve(toSolverPosition(b));
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        PerfSample perf = perfEnabled ? perfCounters.stop() : PerfSample();
+        cout << " Position " << (moves.empty() ? "(empty)" : moves) << ": score " << score << " for " << sideToMove(b)
+             << " (" << solver.nodes << " nodes, " << ms << " ms)\n";
+        if (perfEnabled) cout << "  " << formatPerfSample(perf, solver.nodes) << "\n";
+        return 0;
+    }
+
+    if (hasArg(argc, argv, "--match")) {
+        MatchConfig cfg;
+        cfg.games = getNumberArg<int>(argc, argv, "--games", cfg.games);
+        cfg.threads = getNumberArg<int>(argc, argv, "--threads", (int)max(1u, thread::hardware_concurrency()));
+        cfg.depth = max(1, getNumberArg<int>(argc, argv, "--depth", cfg.depth)); // A depth-0 search has no move
+        cfg.openingPlies = getNumberArg<int>(argc, argv, "--openings", cfg.openingPlies);
+        cfg.budget = parseBudget(argc, argv);
+        if (deterministicMode) cfg.budget.timeMs = 0;
+        cfg.seed = parseSeed(argc, argv);
+        cfg.isScoreAttack = hasArg(argc, argv, "--score-attack");
+        MatchSide sides[2];
+        sides[0].name = "tuned";
+        sides[0].tuning = configuredTuning;
+        sides[1].name = "baseline";
+        sides[1].tuning = configuredTuning;
+        sides[1].tuning.lateMoveReductions = false;
+        sides[1].tuning.futilityPruning = false;
+        sides[1].tuning.nonLosingMoves = false;
+        if (!sides[0].tuning.lateMoveReductions && !sides[0].tuning.futilityPruning && !sides[0].tuning.nonLosingMoves) {
+            cout << " Both sides are identical: enable --lmr, --futility and/or --non-losing.\n";
+        }
+        runMatch(cfg, sides);
+        return 0;
+    }
+
+    if (hasArg(argc, argv, "--loadgen")) {
+        LoadGenConfig cfg;
+        cfg.sessions = getNumberArg<int>(argc, argv, "--sessions", cfg.sessions);
+        cfg.workers = getNumberArg<int>(argc, argv, "--workers", (int)max(1u, thread::hardware_concurrency()));
+        cfg.level = max(1, min(getNumberArg<int>(argc, argv, "--level", 2), (int)DIFFICULTY_PROFILES.size())) - 1;
+        cfg.thinkMedianMs = getNumberArg<double>(argc, argv, "--think-ms", cfg.thinkMedianMs);
+        cfg.thinkSigma = getNumberArg<double>(argc, argv, "--think-sigma", cfg.thinkSigma);
+        cfg.durationSec = getNumberArg<int>(argc, argv, "--duration", cfg.durationSec);
+        cfg.seed = parseSeed(argc, argv);
+        cfg.isScoreAttack = hasArg(argc, argv, "--score-attack");
+        runLoadGenerator(cfg);
+        exportLatencyHistograms();
+        return 0;
+    }
+
+    if (hasArg(argc, argv, "--arena")) {
+        ArenaConfig cfg;
+        if (!deterministicMode) cfg.searchThreads = max(1, getNumberArg<int>(argc, argv, "--search-threads", 1));
+        cfg.games = max(1, getNumberArg<int>(argc, argv, "--games", cfg.games));
+        cfg.threads = getNumberArg<int>(argc, argv, "--threads", (int)max(1u, thread::hardware_concurrency()));
+        cfg.threads = max(1, min(cfg.threads, cfg.games));
+        cfg.level = max(1, min(getNumberArg<int>(argc, argv, "--level", 2), (int)DIFFICULTY_PROFILES.size())) - 1;
+        cfg.fps = max(1, getNumberArg<int>(argc, argv, "--fps", cfg.fps));
+        cfg.durationSec = getNumberArg<int>(argc, argv, "--duration", cfg.durationSec);
+        cfg.moveDelayMs = getNumberArg<int>(argc, argv, "--move-delay", 0);
+        cfg.seed = parseSeed(argc, argv);
+        cfg.isScoreAttack = hasArg(argc, argv, "--score-attack");
+        runArena(cfg);
+        exportLatencyHistograms();
+        return 0;
+    }
+
+    if (hasArg(argc, argv, "--selfplay")) {
+        SelfPlayConfig cfg;
+        cfg.games = getNumberArg<int>(argc, argv, "--games", cfg.games);
+        cfg.threads = getNumberArg<int>(argc, argv, "--threads", (int)max(1u, thread::hardware_concurrency()));
+        cfg.depth = max(1, getNumberArg<int>(argc, argv, "--depth", cfg.depth));
+        cfg.openingPlies = getNumberArg<int>(argc, argv, "--openings", cfg.openingPlies);
+        cfg.temperature = getNumberArg<double>(argc, argv, "--temperature", 0);
+        cfg.seed = parseSeed(argc, argv);
+        if (deterministicMode) cfg.threads = 1; // Dedup and file order depend on which game finishes first
+        cfg.isScoreAttack = hasArg(argc, argv, "--score-attack");
+        cfg.outPath = getArgValue(argc, argv, "--out", cfg.outPath);
+        runSelfPlay(cfg);
+        return 0;
+    }
+
+    // Only the interactive engine joins a host table: the tools above measure or
+    // compare engines, which needs tables nobody else writes to
+    string sharedTableName = getArgValue(argc, argv, "--tt-shm", "");
+    if (!sharedTableName.empty()) {
+        string error;
+        if (!attachSharedTable(sharedTableName, tableMb, hotTableKb, error)) {
+            cout << " Shared table " << sharedTableName << " unavailable (" << error << "), continuing with a private one.\n";
+            this_thread::sleep_for(chrono::seconds(2)); // The rules screen clears it
+        }
+    }
+
     initBoard();
     showRules();
 
     int gameMode, opponentMode;
-    int aiDepth = 2; 
+    int aiLevel = 0; 
 
     cout << CLEAR_SCREEN; 
     cout << "\n " << RED << "┌─────────────────────────────────────────┐" << RESET << "\n";
@@ -433,9 +4094,13 @@ int main() {
      
     if (isAI) {
         cout << CLEAR_SCREEN; 
-        cout << "\n  1. EASY (Depth 2)\n  2. MEDIUM (Depth 4)\n  3. HARD (Depth 6)\n  4. EXPERT (Depth 7)\n  Choice: ";
+        cout << "\n";
+        for (size_t i = 0; i < DIFFICULTY_PROFILES.size(); i++) {
+            cout << "  " << i + 1 << ". " << DIFFICULTY_PROFILES[i].name << " (" << DIFFICULTY_PROFILES[i].budget.nodes / 1000 << "K nodes)\n";
+        }
+        cout << "  Choice: ";
         int diff = getUserInput();
-        if (diff == 1) aiDepth = 2; else if (diff == 2) aiDepth = 4; else if (diff == 3) aiDepth = 6; else aiDepth = 7; 
+        aiLevel = max(1, min(diff, (int)DIFFICULTY_PROFILES.size())) - 1;
     }
 
     string modeTitle = (gameMode == 1) ? "CLASSIC MODE" : "SCORE ATTACK";
@@ -444,6 +4109,14 @@ int main() {
     char current = 'X';
     bool gameOver = false;
     int s1 = 0, s2 = 0;
+    string moveLog;                  // 1-based columns, replayable with setBoardFromMoves
+    uint64_t gameSearchHash = FNV_OFFSET;
+    mt19937 aiRng(parseSeed(argc, argv));
+    PerfSample gamePerf;             // --perf: all AI searches of this game
+    uint64_t gameNodes = 0;
+    unique_ptr<Engine> engine;       // The AI plays through the same async API an embedding server uses
+    if (isAI) engine.reset(new Engine(1, rootSearchThreads));
+    renderer.invalidate(); // The rules and menus replaced the screen
 
     while (!gameOver && moves < maxMoves) {
         if (gameMode == 2) { s1 = calculateFinalScore('X'); s2 = calculateFinalScore('O'); }
@@ -452,33 +4125,23 @@ int main() {
         int targetCol = -1;
 
         if (isAI && current == 'O') {
-            cout << " AI is thinking (Depth " << aiDepth << ")..." << endl;
-            
-            int adaptive_depth = getAdaptiveDepth(board, aiDepth);
-            char boardCopy[ROWS][COLS];
-            for(int i=0; i<ROWS; i++) for(int j=0; j<COLS; j++) boardCopy[i][j] = board[i][j];
-            
-            for (int col = 0; col < COLS; col++) {
-                int row = getNextOpenRow(boardCopy, col);
-                if (row == -1) continue;
-                boardCopy[row][col] = 'O';
-                if (checkWin(boardCopy, 'O') && !isScoreAttack) { targetCol = col; break; }
-                boardCopy[row][col] = ' ';
-                boardCopy[row][col] = 'X';
-                if (checkWin(boardCopy, 'X') && !isScoreAttack) { targetCol = col; break; }
-                boardCopy[row][col] = ' ';
-            }
-            
-            if (targetCol == -1) {
-                pair<int, int> result = minimax(boardCopy, adaptive_depth, 
-                                                    INT_MIN, INT_MAX, true, 
-                                                    isScoreAttack, adaptive_depth);
-                targetCol = result.first;
-            }
+            cout << " AI is thinking (" << DIFFICULTY_PROFILES[aiLevel].name << ")..." << flush; // Visible before the search starts
 
-            if (targetCol == -1) {
-                for(int k=0; k<COLS; k++) if(getNextOpenRow(board, k) != -1) { targetCol = k; break; }
-            }
+            MoveRequest request;
+            request.moves = moveLog;
+            request.level = aiLevel + 1;
+            request.scoreAttack = isScoreAttack;
+            request.seed = aiRng();
+            if (perfEnabled) perfCounters.start();
+            PendingMove pending = engine->requestMove(request);
+            while (pending.result.wait_for(chrono::milliseconds(250)) != future_status::ready) cout << "." << flush;
+            MoveResult result = pending.result.get();
+            if (perfEnabled) gamePerf.add(perfCounters.stop());
+            cout << "\n";
+            targetCol = result.column;
+            gameNodes += result.nodes;
+            exportLatencyIfRequested();
+            gameSearchHash = fnv1a(gameSearchHash, result.searchHash);
 
         } else {
             cout << " Player " << (current == 'X' ? RED : BLUE) << current << RESET << ", choose column (1-7): ";
@@ -488,6 +4151,7 @@ int main() {
 
         if (dropPiece(targetCol, current)) {
             moves++;
+            moveLog += (char)('1' + targetCol);
             if (gameMode == 1) { 
                 if (checkWin(board, current)) {
                     if (current == 'X') s1 = 1; else s2 = 1;
@@ -506,13 +4170,21 @@ int main() {
     if (gameMode == 2) {
         s1 = calculateFinalScore('X'); s2 = calculateFinalScore('O');
         printBoard(s1, s2, modeTitle);
-        cout << "\n FINAL SCORE: X=" << s1 << " | O=" << s2 << endl;
+        cout << "\n FINAL SCORE: X=" << s1 << " | O=" << s2 << "\n";
         if (s1 > s2) cout << " 🏆 PLAYER X WINS! 🏆\n";
-        else if (s2 > s1) cout << " 🤖 AI WINS! 🤖" << endl;
+        else if (s2 > s1) cout << " 🤖 AI WINS! 🤖\n";
         else cout << " 🤝 DRAW! 🤝\n";
     } else if (moves >= maxMoves && !gameOver) {
         cout << " 🤝 DRAW! Board is full.\n";
     }
 
+    exportLatencyHistograms();
+    if (perfEnabled && gameNodes > 0) cout << " AI search counters: " << formatPerfSample(gamePerf, gameNodes) << "\n";
+
+    if (deterministicMode) {
+        cout << " Replay: moves " << moveLog << "  search hash " << hex << gameSearchHash << dec << "\n";
+    }
+
     return 0;
 }
+#endif // CONNECT4_NO_MAIN
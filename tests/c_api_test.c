@@ -0,0 +1,148 @@
+/*
+    CONNECT 4 - C API TEST
+        Plain C, linked against the shared library, so it checks the ABI the
+        way another language's FFI sees it: error codes, a forced win, batch
+        statuses, mirror symmetry of the static evaluation, agreement
+        between batch search scores and single searches, and depth-1 scores
+        against the depth-0 scores of the children. Ends with the batch
+        evaluation throughput.
+
+        Build:  g++ -O3 -pthread -shared -fPIC -fvisibility=hidden -DCONNECT4_NO_MAIN main.cpp -o libconnect4.so
+                gcc -O2 -o c_api_test tests/c_api_test.c -L. -lconnect4 -Wl,-rpath,.
+        Run:    ./c_api_test
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../connect4.h"
+
+static int failures = 0;
+
+static void check(int ok, const char* what) {
+    printf("%s%s\n", ok ? "  ok    " : "  FAIL  ", what);
+    if (!ok) failures++;
+}
+
+/* Column c becomes 8 - c: the mirrored game */
+static void mirrorMoves(const char* moves, char* out) {
+    size_t i;
+    for (i = 0; moves[i]; i++) out[i] = (char)('8' - (moves[i] - '0'));
+    out[i] = '\0';
+}
+
+int main(void) {
+    static const char* positions[] = {"", "44", "4453", "443322", "4433525", "3443553256", "3246117513",
+                                      "515211441215", "4175126651554121", "53267556661477767544"};
+    const size_t count = sizeof(positions) / sizeof(positions[0]);
+    c4_engine* engine;
+    c4_limits limits;
+    c4_search_result result;
+    size_t i;
+
+    check(c4_api_version() == C4_API_VERSION, "api version");
+    engine = c4_create();
+    check(engine != NULL, "create");
+
+    check(c4_attach_shared_table(NULL, 8) == C4_INVALID_ARGUMENT && c4_attach_shared_table("/c4", 0) == C4_INVALID_ARGUMENT,
+          "shared table needs a name and a size");
+    check(c4_set_position(engine, "18") == C4_INVALID_MOVES, "bad column is rejected");
+    check(c4_set_position(engine, "1111111") == C4_INVALID_MOVES, "full column is rejected");
+    memset(&limits, 0, sizeof(limits));
+    check(c4_search(engine, &limits, &result) == C4_INVALID_ARGUMENT, "search without any limit is rejected");
+
+    limits.depth = 6;
+    check(c4_set_position(engine, "1212121") == C4_OK && c4_search(engine, &limits, &result) == C4_GAME_OVER,
+          "finished game cannot be searched");
+    check(c4_set_position(engine, "121212") == C4_OK && c4_search(engine, &limits, &result) == C4_OK &&
+          result.column == 0, "X plays the winning column");
+    check(c4_set_position(engine, "4453") == C4_OK && c4_search(engine, &limits, &result) == C4_OK &&
+          result.depth == 6 && result.nodes > 0, "depth-6 search reports its depth and nodes");
+
+    {
+        const char* mixed[] = {"44", "9", "1212121", NULL};
+        int32_t scores[4], statuses[4];
+        check(c4_evaluate_batch(engine, mixed, 4, 0, 0, scores, statuses) == C4_OK &&
+              statuses[0] == C4_OK && statuses[1] == C4_INVALID_MOVES && statuses[2] == C4_GAME_OVER &&
+              statuses[3] == C4_INVALID_MOVES, "batch reports a status per position");
+    }
+
+    {
+        const char* mirrored[sizeof(positions) / sizeof(positions[0])];
+        char buffers[sizeof(positions) / sizeof(positions[0])][64];
+        int32_t a[16], b[16], sa[16], sb[16];
+        int same = 1;
+        for (i = 0; i < count; i++) { mirrorMoves(positions[i], buffers[i]); mirrored[i] = buffers[i]; }
+        c4_evaluate_batch(engine, positions, count, 0, 0, a, sa);
+        c4_evaluate_batch(engine, mirrored, count, 0, 0, b, sb);
+        for (i = 0; i < count; i++) same = same && sa[i] == C4_OK && a[i] == b[i];
+        check(same, "static evaluation is mirror-symmetric");
+    }
+
+    {
+        int32_t scores[16], statuses[16];
+        int agree = 1, compared = 0;
+        c4_evaluate_batch(engine, positions, count, 5, 0, scores, statuses);
+        limits.depth = 5;
+        for (i = 0; i < count; i++) {
+            c4_set_position(engine, positions[i]);
+            if (c4_search(engine, &limits, &result) != C4_OK || result.depth != 5) continue; /* Win/block scan */
+            compared++;
+            agree = agree && statuses[i] == C4_OK && scores[i] == result.score;
+        }
+        check(agree && compared > 0, "batch depth-5 scores match single searches");
+    }
+
+    {
+        /* Opening positions: no wins or threats, so depth 1 is plain negamax over the children */
+        const char* parents[] = {"", "44", "4453", "4433"};
+        int agree = 1;
+        size_t p;
+        for (p = 0; p < sizeof(parents) / sizeof(parents[0]); p++) {
+            const char* children[7];
+            char buffers[7][64];
+            int32_t parent, parentStatus, scores[7], statuses[7], best = 0;
+            int c;
+            for (c = 0; c < 7; c++) {
+                snprintf(buffers[c], sizeof(buffers[c]), "%s%d", parents[p], c + 1);
+                children[c] = buffers[c];
+            }
+            c4_evaluate_batch(engine, &parents[p], 1, 1, 0, &parent, &parentStatus);
+            c4_evaluate_batch(engine, children, 7, 0, 0, scores, statuses);
+            for (c = 0; c < 7; c++) {
+                agree = agree && statuses[c] == C4_OK;
+                if (c == 0 || -scores[c] > best) best = -scores[c];
+            }
+            agree = agree && parentStatus == C4_OK && parent == best;
+        }
+        check(agree, "batch depth-1 score is negamax over depth-0 child scores");
+    }
+
+    {
+        const size_t n = 100000;
+        const char** batch = malloc(n * sizeof(char*));
+        char* text = malloc(n * 32);
+        int32_t* scores = malloc(n * sizeof(int32_t));
+        int32_t* statuses = malloc(n * sizeof(int32_t));
+        clock_t start;
+        double seconds;
+        srand(1);
+        for (i = 0; i < n; i++) {
+            int plies = rand() % 20, p;
+            for (p = 0; p < plies; p++) text[i * 32 + p] = (char)('1' + rand() % 7);
+            text[i * 32 + plies] = '\0';
+            batch[i] = text + i * 32;
+        }
+        start = clock();
+        check(c4_evaluate_batch(engine, batch, n, 0, 0, scores, statuses) == C4_OK, "100000-position static batch");
+        seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+        printf("  batch static evaluation: %.0f positions/s\n", n / (seconds > 0 ? seconds : 1e-9));
+        free(batch); free(text); free(scores); free(statuses);
+    }
+
+    c4_destroy(engine);
+    printf("%s", failures ? " FAILED\n" : " C API behaves as documented.\n");
+    return failures ? 1 : 0;
+}
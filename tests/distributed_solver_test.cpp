@@ -0,0 +1,127 @@
+/*
+    CONNECT 4 - DISTRIBUTED SOLVER TEST
+        Runs the coordinator and its workers as separate local processes and
+        checks the merged results against the known exact values:
+
+        - workers started before the coordinator, over a Unix socket;
+        - workers forked by the coordinator, over TCP on an ephemeral port;
+        - a worker that takes a job and disappears without answering (the
+          job must be handed to another worker);
+        - local workers that all fail, and no worker at all: the coordinator
+          must give up instead of waiting forever.
+
+        Every root move's score must back up to the position's value.
+
+        Build:  g++ -O3 -pthread -o distributed_solver_test tests/distributed_solver_test.cpp
+        Run:    ./distributed_solver_test [--dir tests/positions]
+*/
+
+#define CONNECT4_NO_MAIN
+#include "../main.cpp"
+
+int failures = 0;
+
+void check(bool ok, const string& what) {
+    cout << (ok ? "  ok    " : "  FAIL  ") << what << "\n";
+    if (!ok) failures++;
+}
+
+// Known score and merged root moves agree
+bool consistent(const DistributedSolveResult& r, int expected) {
+    if (!r.ok || r.score != expected || r.bestColumn < 0 || r.moveScores[r.bestColumn] != expected) return false;
+    for (int c = 0; c < COLS; c++) if (r.moveScores[c] != INT_MIN && r.moveScores[c] > expected) return false;
+    return true;
+}
+
+template <typename F>
+pid_t spawn(F body) {
+    cout.flush();
+    pid_t pid = fork();
+    if (pid == 0) _exit(body());
+    return pid;
+}
+
+int main(int argc, char** argv) {
+    string dir = getArgValue(argc, argv, "--dir", "tests/positions");
+    vector<pair<string, int>> positions;
+    ifstream in(dir + "/middle_easy.txt");
+    string moves;
+    int score;
+    while ((int)positions.size() < 4 && in >> moves >> score) positions.push_back({moves, score});
+    if (positions.empty()) { cout << " No positions in " << dir << "/middle_easy.txt\n"; return 1; }
+
+    // Long enough (about 0.2 s) that both external workers connect before it is solved
+    ifstream slower(dir + "/begin_easy.txt");
+    pair<string, int> external;
+    if (!(slower >> external.first >> external.second)) { cout << " No positions in " << dir << "/begin_easy.txt\n"; return 1; }
+
+    string socketPath = "/tmp/c4-distributed-test-" + to_string(getpid()) + ".sock";
+
+    // Workers first: they wait for the coordinator to appear
+    vector<pid_t> workers;
+    for (int w = 0; w < 2; w++) {
+        workers.push_back(spawn([&]() {
+            string error;
+            return runSolveWorker("unix:" + socketPath, 16, 10000, error) < 0 ? 1 : 0;
+        }));
+    }
+    this_thread::sleep_for(chrono::milliseconds(200));
+    DistributedSolveResult r = solveDistributed(external.first, "unix:" + socketPath, 2, 0, 16);
+    bool workersExited = true;
+    for (pid_t pid : workers) {
+        int status = 0;
+        waitpid(pid, &status, 0);
+        workersExited = workersExited && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    }
+    check(consistent(r, external.second) && r.workers >= 1, "Unix socket, 2 external workers: exact value");
+    check(workersExited && access(socketPath.c_str(), F_OK) != 0, "workers leave on DONE and the socket file is removed");
+
+    bool allMatch = true;
+    for (auto& p : positions) {
+        DistributedSolveResult t = solveDistributed(p.first, "127.0.0.1:0", 2, 3, 16);
+        if (!consistent(t, p.second)) {
+            cout << "  " << p.first << ": expected " << p.second << ", got " << (t.ok ? to_string(t.score) : t.error) << "\n";
+            allMatch = false;
+        }
+    }
+    check(allMatch, "TCP, 3 forked workers: exact values of " + to_string(positions.size()) + " positions");
+
+    // A worker that vanishes holding a job, then an honest one
+    pid_t quitter = spawn([&]() {
+        string error, buffer, line;
+        int fd = connectTo("unix:" + socketPath, 10000, error);
+        if (fd < 0 || !sendLine(fd, "HELLO") || !readLine(fd, buffer, line)) return 1;
+        close(fd);
+        return line.rfind("SOLVE", 0) == 0 ? 0 : 1;
+    });
+    pid_t honest = spawn([&]() {
+        this_thread::sleep_for(chrono::milliseconds(500)); // After the quitter has its job
+        string error;
+        return runSolveWorker("unix:" + socketPath, 16, 10000, error) < 0 ? 1 : 0;
+    });
+    r = solveDistributed(positions[1].first, "unix:" + socketPath, 1, 0, 16);
+    int quitterStatus = 0;
+    waitpid(quitter, &quitterStatus, 0);
+    waitpid(honest, nullptr, 0);
+    check(WIFEXITED(quitterStatus) && WEXITSTATUS(quitterStatus) == 0 && r.requeued >= 1 && consistent(r, positions[1].second),
+          "a job left by a vanished worker is requeued and solved");
+
+    DistributedSolveResult bad = solveDistributed("1212121", "127.0.0.1:0", 2, 1, 16);
+    check(!bad.ok && !bad.error.empty(), "a finished game is refused before any worker starts");
+
+    // Solver tables no machine can allocate: every forked worker exits at once
+    auto start = chrono::steady_clock::now();
+    bad = solveDistributed(positions[0].first, "127.0.0.1:0", 2, 2, 1 << 30, false, 0);
+    double waited = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    check(!bad.ok && bad.error.find("local workers exited") != string::npos && waited < 10,
+          "the coordinator gives up when every local worker has exited");
+
+    start = chrono::steady_clock::now();
+    bad = solveDistributed(positions[0].first, "127.0.0.1:0", 2, 0, 16, false, 1);
+    waited = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    check(!bad.ok && bad.error.find("no worker connected") != string::npos && waited < 10,
+          "the coordinator gives up after its timeout with no worker");
+
+    cout << (failures ? " FAILED\n" : " Distributed solver matches the known values.\n");
+    return failures ? 1 : 0;
+}
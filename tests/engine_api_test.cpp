@@ -0,0 +1,117 @@
+/*
+    CONNECT 4 - ASYNC ENGINE API TEST
+        Uses only the public header, linked against the engine library, so it
+        also checks that the library builds and links without the console.
+        Covers forced moves, invalid requests, many concurrent requests with
+        completion callbacks, cancellation, deadlines, requests that expire in
+        the queue and shutdown with requests still pending.
+
+        Build:  g++ -O3 -pthread -DCONNECT4_NO_MAIN -c main.cpp -o connect4_engine.o
+                g++ -O3 -pthread -o engine_api_test tests/engine_api_test.cpp connect4_engine.o
+        Run:    ./engine_api_test
+*/
+
+#include <iostream>
+#include <vector>
+#include <thread>
+
+#include "../engine.h"
+
+using namespace std;
+
+int failures = 0;
+
+void check(bool ok, const string& what) {
+    cout << (ok ? "  ok    " : "  FAIL  ") << what << "\n";
+    if (!ok) failures++;
+}
+
+MoveRequest depthRequest(const string& moves, int depth) {
+    MoveRequest req;
+    req.moves = moves;
+    req.depth = depth;
+    return req;
+}
+
+double elapsedMs(chrono::steady_clock::time_point start) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+int main() {
+    {
+        Engine engine(2);
+        MoveResult win = engine.requestMove(depthRequest("121212", 6)).result.get();
+        check(win.status == MOVE_DONE && win.column == 0, "X completes the column-1 four");
+        MoveResult block = engine.requestMove(depthRequest("12121", 6)).result.get();
+        check(block.status == MOVE_DONE && block.column == 0, "O blocks the column-1 four");
+
+        check(engine.requestMove(depthRequest("18", 4)).result.get().status == MOVE_INVALID, "bad column is rejected");
+        check(engine.requestMove(depthRequest("1111111", 4)).result.get().status == MOVE_INVALID, "move into a full column is rejected");
+        check(engine.requestMove(depthRequest("1212121", 4)).result.get().status == MOVE_INVALID, "finished game is rejected");
+
+        MoveResult a = engine.requestMove(depthRequest("4453", 7)).result.get();
+        MoveResult b = engine.requestMove(depthRequest("4453", 7)).result.get();
+        check(a.status == MOVE_DONE && a.scored && a.column == b.column && a.score == b.score,
+              "repeated request returns the same move and score");
+    }
+
+    {
+        Engine engine(4);
+        atomic<int> callbacks(0);
+        vector<PendingMove> pending;
+        for (int i = 0; i < 32; i++) {
+            MoveRequest req;
+            req.moves = string(1, (char)('1' + i % 7)) + string(1, (char)('1' + (i / 7) % 7));
+            req.level = 1;
+            req.seed = i;
+            req.onComplete = [&callbacks](const MoveResult&) { callbacks++; };
+            pending.push_back(engine.requestMove(req));
+        }
+        bool allDone = true;
+        for (auto& p : pending) {
+            MoveResult r = p.result.get();
+            allDone = allDone && r.status == MOVE_DONE && r.column >= 0 && r.column < 7;
+        }
+        this_thread::sleep_for(chrono::milliseconds(50)); // Callbacks run just after the futures complete
+        check(allDone, "32 concurrent level-1 requests on 4 workers all complete");
+        check(callbacks.load() == 32, "onComplete ran for every request");
+    }
+
+    {
+        Engine engine(1);
+        auto start = chrono::steady_clock::now();
+        PendingMove slow = engine.requestMove(depthRequest("", 30));
+        this_thread::sleep_for(chrono::milliseconds(100));
+        slow.cancel();
+        MoveResult r = slow.result.get();
+        check(r.status == MOVE_CANCELLED && elapsedMs(start) < 2000, "cancel ends a deep search promptly");
+
+        MoveRequest timed = depthRequest("", 30);
+        timed.deadline = chrono::milliseconds(300);
+        start = chrono::steady_clock::now();
+        PendingMove bounded = engine.requestMove(timed);
+        MoveRequest late = depthRequest("44", 4);
+        late.deadline = chrono::milliseconds(50);
+        PendingMove expired = engine.requestMove(late); // Queued behind the 300 ms search
+        r = bounded.result.get();
+        check(r.status == MOVE_DONE && r.column >= 0 && elapsedMs(start) < 1500,
+              "deadline returns the best move found in time");
+        check(expired.result.get().status == MOVE_EXPIRED, "request whose deadline passed in the queue expires");
+    }
+
+    {
+        vector<PendingMove> pending;
+        auto start = chrono::steady_clock::now();
+        {
+            Engine engine(1);
+            for (int i = 0; i < 4; i++) pending.push_back(engine.requestMove(depthRequest("", 30)));
+            this_thread::sleep_for(chrono::milliseconds(50));
+        }
+        bool allCancelled = true;
+        for (auto& p : pending) allCancelled = allCancelled && p.result.get().status == MOVE_CANCELLED;
+        check(allCancelled && elapsedMs(start) < 2000, "shutdown completes running and queued requests as cancelled");
+    }
+
+    cout << (failures ? " FAILED\n" : " Engine API behaves as documented.\n");
+    return failures ? 1 : 0;
+}
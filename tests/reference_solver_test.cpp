@@ -0,0 +1,176 @@
+/*
+    CONNECT 4 - REFERENCE SOLVER CROSS-CHECK
+        The values in tests/positions were computed by the engine's own solver,
+        so solver_test can only catch regressions. This program checks them
+        against a second solver that shares no code with main.cpp: a plain
+        char board, a win test around the last stone, and a full-window
+        negamax with a map of lower/upper bounds. It is far slower than the
+        engine's solver, so it checks a fixed sample:
+
+            end_easy        every position                    (under 0.1 s)
+            middle_easy     every position                    (about 2 s)
+            middle_medium   every position                    (about 20 s)
+            begin_easy      every position           (--slow)  (about 2 min)
+            begin_medium    lines 1, 21, 41, 61, 81  (--slow)  (about 30 s)
+            begin_hard      lines 1, 21, 41, 61, 81  (--slow)  (about 2 min)
+
+        All 410 values above agreed when the sets were cross-checked. The
+        other 190 begin-set values are checked only by solver_test.
+
+        Scores use the same convention as the files: 0 = draw, 22 - k = win
+        with the winner's k-th stone, from the side to move.
+
+        Build:  g++ -O3 -o reference_solver_test tests/reference_solver_test.cpp
+        Run:    ./reference_solver_test [--dir tests/positions] [--slow]
+*/
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+const int W = 7, H = 6, CELLS = W * H;
+
+struct Reference {
+    char cell[W][H];        // [column][row from the bottom]: 0 empty, 1 first player, 2 second
+    int height[W];
+    int played = 0;
+    uint64_t code = 0;      // Per column, 7 bits: a 1 above the stones, stone bits below it
+    uint64_t nodes = 0;
+    unordered_map<uint64_t, pair<int, int>> bounds; // code -> {lower, upper}
+
+    bool load(const string& moves) {
+        for (int c = 0; c < W; c++) { height[c] = 0; for (int r = 0; r < H; r++) cell[c][r] = 0; }
+        played = 0;
+        code = 0;
+        for (int c = 0; c < W; c++) code |= 1ULL << (c * 7);
+        for (char ch : moves) {
+            int c = ch - '1';
+            if (c < 0 || c >= W || height[c] == H || wins(c)) return false;
+            play(c);
+        }
+        return true;
+    }
+
+    int mover() const { return 1 + played % 2; }
+
+    // Would dropping a stone of the side to move in column c connect four?
+    bool wins(int c) const {
+        int r = height[c], p = mover();
+        const int dirs[4][2] = {{1, 0}, {0, 1}, {1, 1}, {1, -1}};
+        for (auto& d : dirs) {
+            int count = 1;
+            for (int s = -1; s <= 1; s += 2) {
+                int x = c + s * d[0], y = r + s * d[1];
+                while (x >= 0 && x < W && y >= 0 && y < H && cell[x][y] == p) { count++; x += s * d[0]; y += s * d[1]; }
+            }
+            if (count >= 4) return true;
+        }
+        return false;
+    }
+
+    void play(int c) {
+        int r = height[c]++;
+        cell[c][r] = (char)mover();
+        // Moves the column's marker bit up one; the stone bit records the mover
+        code += 1ULL << (c * 7 + r);
+        if (cell[c][r] == 2) code |= 1ULL << (c * 7 + r);
+        played++;
+    }
+
+    void undo(int c) {
+        played--;
+        int r = --height[c];
+        if (cell[c][r] == 2) code &= ~(1ULL << (c * 7 + r));
+        code -= 1ULL << (c * 7 + r);
+        cell[c][r] = 0;
+    }
+
+    int negamax(int alpha, int beta) {
+        nodes++;
+        if (played == CELLS) return 0;
+        for (int c = 0; c < W; c++) if (height[c] < H && wins(c)) return (CELLS + 1 - played) / 2;
+
+        // No win now: at best a win with our next stone, at worst a loss to theirs
+        int hi = (CELLS - 1 - played) / 2, lo = -(CELLS - played) / 2;
+        auto known = bounds.find(code);
+        if (known != bounds.end()) { lo = max(lo, known->second.first); hi = min(hi, known->second.second); }
+        if (lo >= beta) return lo;
+        if (hi <= alpha) return hi;
+        if (lo == hi) return lo;
+        alpha = max(alpha, lo);
+        beta = min(beta, hi);
+
+        static const int order[W] = {3, 2, 4, 1, 5, 0, 6};
+        int best = -CELLS, alphaOrig = alpha;
+        for (int c : order) {
+            if (height[c] == H) continue;
+            play(c);
+            int v = -negamax(-beta, -alpha);
+            undo(c);
+            if (v > best) best = v;
+            if (best > alpha) alpha = best;
+            if (alpha >= beta) break;
+        }
+
+        if (best <= alphaOrig) hi = best;
+        else if (best >= beta) lo = best;
+        else lo = hi = best;
+        bounds[code] = {lo, hi};
+        return best;
+    }
+
+    int solve() {
+        bounds.clear();
+        nodes = 0;
+        return negamax(-CELLS, CELLS);
+    }
+};
+
+int main(int argc, char** argv) {
+    string dir = "tests/positions";
+    bool slow = false;
+    for (int i = 1; i < argc; i++) {
+        if (string(argv[i]) == "--dir" && i + 1 < argc) dir = argv[++i];
+        else if (string(argv[i]) == "--slow") slow = true;
+    }
+
+    struct Sample { string name; int every; bool slow; };
+    const vector<Sample> samples = {{"end_easy", 1, false}, {"middle_easy", 1, false}, {"middle_medium", 1, false},
+                                    {"begin_easy", 1, true}, {"begin_medium", 20, true}, {"begin_hard", 20, true}};
+
+    Reference ref;
+    int checked = 0, failures = 0;
+    printf(" %-14s %8s %9s %12s\n", "set", "checked", "failures", "mean time");
+    for (const Sample& s : samples) {
+        if (s.slow && !slow) continue;
+        ifstream in(dir + "/" + s.name + ".txt");
+        if (!in) { cout << "  cannot open " << dir << "/" << s.name << ".txt\n"; failures++; continue; }
+        string moves;
+        int expected, line = 0, setChecked = 0, setFailures = 0;
+        double seconds = 0;
+        while (in >> moves >> expected) {
+            if (line++ % s.every != 0) continue;
+            setChecked++;
+            if (!ref.load(moves)) { cout << "  " << moves << ": invalid or finished position\n"; setFailures++; continue; }
+            auto start = chrono::steady_clock::now();
+            int score = ref.solve();
+            seconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            if (score != expected) {
+                cout << "  " << s.name << " line " << line << " " << moves << ": reference " << score << ", file " << expected << "\n";
+                setFailures++;
+            }
+        }
+        printf(" %-14s %8d %9d %9.1f ms\n", s.name.c_str(), setChecked, setFailures, 1000.0 * seconds / max(setChecked, 1));
+        checked += setChecked;
+        failures += setFailures;
+    }
+    cout << (failures ? " FAILED\n" : " " + to_string(checked) + " stored values agree with the reference solver.\n");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,179 @@
+/*
+    CONNECT 4 - SHARED-MEMORY TRANSPOSITION TABLE TEST
+        Forks real processes, each attaching the segment on its own, so it
+        checks what --tt-shm promises between processes rather than threads:
+
+        - Four processes create/attach the same segment at once and hammer
+          it; every entry's data is a function of its key, so a torn or
+          misverified entry shows up as a mismatch. Afterwards a fresh
+          process finds every process's marker entries, and is refused a
+          second segment.
+        - A process searches the bench positions; a second process started
+          afterwards gets the same moves and scores for a fraction of the nodes.
+        - A segment that is not a table is refused.
+
+        Build:  g++ -O3 -pthread -o shared_tt_test tests/shared_tt_test.cpp
+        Run:    ./shared_tt_test
+*/
+
+#define CONNECT4_NO_MAIN
+#include "../main.cpp"
+
+#include <sys/wait.h>
+
+const int PROCESSES = 4;
+const int MARKERS = 2000;  // Per process, at main-tier depth, in a table far larger than that
+
+MemoEntry entryFor(uint64_t key) {
+    uint64_t h = key * 0x9E3779B97F4A7C15ULL;
+    MemoEntry e = {(int)(h % COLS), (int)((int64_t)(h >> 32) % 100000000), (MemoBound)((h >> 8) % 3)};
+    e.depth = (int)((h >> 16) % (2 * (HOT_TT_MAX_DEPTH + 1)));
+    return e;
+}
+
+const int HAMMER_KEYS = 50000;
+
+// Markers for every process, then the keys the processes hammer. All check bits
+// differ, so a probe can only match its own key (two positions sharing check
+// bits and slot would be a rare, legitimate false hit, not a bug), and every
+// marker has its own main-tier slot so none evicts another.
+vector<uint64_t> testKeys(size_t mainSlots) {
+    vector<uint64_t> keys;
+    unordered_set<uint64_t> checks, slots;
+    for (uint64_t key = 1; keys.size() < (size_t)PROCESSES * MARKERS + HAMMER_KEYS; key++) {
+        if (checks.count(slotIndex(key) >> KEY_CHECK_SHIFT)) continue;
+        bool marker = keys.size() < (size_t)PROCESSES * MARKERS;
+        if (marker && !slots.insert(slotIndex(key) & (mainSlots - 1)).second) continue;
+        checks.insert(slotIndex(key) >> KEY_CHECK_SHIFT);
+        keys.push_back(key);
+    }
+    return keys;
+}
+
+MemoEntry markerEntry(uint64_t key) {
+    MemoEntry e = entryFor(key);
+    e.depth = HOT_TT_MAX_DEPTH + 10; // Main tier, deeper than anything the hammering stores
+    return e;
+}
+
+// Runs 'body' in a child process; its return value is the exit status
+template <typename F>
+pid_t spawn(F body) {
+    cout.flush(); // Or the child inherits (and repeats) what is still buffered
+    pid_t pid = fork();
+    if (pid == 0) _exit(body());
+    return pid;
+}
+
+int waitFor(pid_t pid) {
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return WIFEXITED(status) ? WEXITSTATUS(status) : 100;
+}
+
+int failures = 0;
+
+void check(bool ok, const string& what) {
+    cout << (ok ? "  ok    " : "  FAIL  ") << what << "\n";
+    if (!ok) failures++;
+}
+
+// Searches every bench position; one line per position on 'out': column, score, nodes
+int searchBench(const string& name, FILE* out) {
+    string error;
+    if (!attachSharedTable(name, 16, 64, error)) { cerr << error << "\n"; return 2; }
+    for (const string& moves : BENCH_POSITIONS) {
+        char b[ROWS][COLS];
+        setBoardFromMoves(b, moves);
+        newSearchGeneration();
+        searchStats = SearchStats();
+        pair<int, int> result = parallelRootSearch(b, 8, sideToMove(b) == 'O', false, 1);
+        fprintf(out, "%d %d %llu\n", result.first, result.second, (unsigned long long)searchStats.nodes);
+    }
+    fflush(out); // _exit does not
+    return 0;
+}
+
+int main() {
+    string name = "/c4tt-test-" + to_string(getpid());
+    shm_unlink(name.c_str());
+
+    // Concurrent attach and hammering
+    vector<uint64_t> keys = testKeys(tierSlots(4 << 20));
+    vector<uint64_t> markers(keys.begin(), keys.begin() + PROCESSES * MARKERS);
+    vector<pid_t> children;
+    for (int p = 0; p < PROCESSES; p++) {
+        children.push_back(spawn([&, p]() {
+            string error;
+            if (!attachSharedTable(name, 4, 64, error)) { cerr << error << "\n"; return 2; }
+            for (int i = 0; i < MARKERS; i++) {
+                uint64_t key = markers[p * MARKERS + i];
+                hostTable.store(key, markerEntry(key));
+            }
+            mt19937_64 rng(p);
+            int corrupt = 0;
+            auto until = chrono::steady_clock::now() + chrono::milliseconds(500);
+            while (chrono::steady_clock::now() < until) {
+                for (int i = 0; i < 1000; i++) {
+                    uint64_t key = keys[PROCESSES * MARKERS + rng() % HAMMER_KEYS];
+                    MemoEntry expected = entryFor(key), e;
+                    if (hostTable.find(key, expected.depth, e) != TT_MISS &&
+                        (e.col != expected.col || e.score != expected.score || e.bound != expected.bound))
+                        corrupt++;
+                    hostTable.store(key, expected);
+                }
+            }
+            return corrupt ? 1 : 0;
+        }));
+    }
+    bool clean = true;
+    for (pid_t pid : children) clean = waitFor(pid) == 0 && clean;
+    check(clean, "4 processes attach at once and never read a torn entry");
+
+    pid_t reader = spawn([&]() {
+        string error;
+        if (!attachSharedTable(name, 1, 0, error)) return 2; // Sizes come from the segment
+        if (hostTable.main.slotCount != tierSlots(4 << 20)) return 3;
+        if (attachSharedTable(name + "-other", 1, 0, error) || hostTable.main.slotCount != tierSlots(4 << 20)) return 4;
+        for (uint64_t key : markers) {
+            MemoEntry e;
+            if (hostTable.find(key, markerEntry(key).depth, e) != TT_MAIN || e.score != markerEntry(key).score) return 1;
+        }
+        return 0;
+    });
+    check(waitFor(reader) == 0, "a new process adopts the segment's size, sees every process's entries and can't re-attach");
+    shm_unlink(name.c_str());
+
+    // Warm start
+    FILE* cold = tmpfile();
+    FILE* warm = tmpfile();
+    bool ran = waitFor(spawn([&]() { return searchBench(name, cold); })) == 0;
+    ran = waitFor(spawn([&]() { return searchBench(name, warm); })) == 0 && ran;
+    rewind(cold);
+    rewind(warm);
+    bool same = ran;
+    unsigned long long coldNodes = 0, warmNodes = 0;
+    for (size_t i = 0; i < BENCH_POSITIONS.size() && ran; i++) {
+        int c1, s1, c2, s2;
+        unsigned long long n1, n2;
+        if (fscanf(cold, "%d %d %llu", &c1, &s1, &n1) != 3 || fscanf(warm, "%d %d %llu", &c2, &s2, &n2) != 3) { same = false; break; }
+        same = same && c1 == c2 && s1 == s2;
+        coldNodes += n1;
+        warmNodes += n2;
+    }
+    cout << "  bench positions at depth 8: " << coldNodes << " nodes cold, " << warmNodes << " warm\n";
+    check(same, "a second process finds the same moves and scores");
+    check(ran && warmNodes * 10 < coldNodes, "a second process starts warm (under 10% of the nodes)");
+    shm_unlink(name.c_str());
+
+    // Foreign segment
+    int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    bool made = fd >= 0 && ftruncate(fd, 1 << 16) == 0 && write(fd, "not a table", 11) == 11;
+    if (fd >= 0) close(fd);
+    string error;
+    check(made && !attachSharedTable(name, 1, 0, error) && !hostTableAttached, "a segment that is not a table is refused");
+    shm_unlink(name.c_str());
+
+    cout << (failures ? " FAILED\n" : " Shared-memory table behaves as documented.\n");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,97 @@
+/*
+    CONNECT 4 - SOLVER REGRESSION TEST
+        Solves position sets with known exact values and fails on any mismatch.
+        Each file has one position per line: "<moves> <score>", moves as 1-based
+        columns from the empty board, score from the side to move (0 = draw,
+        22 - k = win with the winner's k-th stone, negative = loss).
+
+        On the end-game set the regular minimax is also run to the end of the
+        game and must agree on win / draw / loss, which catches memo bugs such
+        as bound-derived scores being reused as exact.
+
+        Build:  g++ -O3 -pthread -o solver_test tests/solver_test.cpp
+        Run:    ./solver_test [--dir tests/positions] [set names...]
+*/
+
+#define CONNECT4_NO_MAIN
+#include "../main.cpp"
+
+struct SetResult {
+    int positions = 0;
+    int failures = 0;
+    double seconds = 0;
+    uint64_t nodes = 0;
+};
+
+int outcome(int score) { return (score > 0) - (score < 0); }
+
+// Win / draw / loss of the minimax value, seen from the side to move
+int minimaxOutcome(char b[ROWS][COLS], char toMove) {
+    int empties = 0;
+    for (int i = 0; i < ROWS; i++) for (int j = 0; j < COLS; j++) if (b[i][j] == ' ') empties++;
+    clearMemo();
+    int score = minimax(b, empties, INT_MIN, INT_MAX, toMove == 'O', false, empties).second;
+    int result = (score >= 1000000 - ROWS * COLS) ? 1 : (score <= -1000000 + ROWS * COLS) ? -1 : 0;
+    return toMove == 'O' ? result : -result;
+}
+
+SetResult runSet(const string& path, bool checkMinimax, Solver& solver) {
+    SetResult r;
+    ifstream in(path);
+    if (!in) {
+        cout << "  cannot open " << path << "\n";
+        r.failures = 1;
+        return r;
+    }
+    string moves;
+    int expected;
+    while (in >> moves >> expected) {
+        char b[ROWS][COLS];
+        r.positions++;
+        if (!setBoardFromMoves(b, moves)) {
+            cout << "  " << moves << ": invalid move sequence\n";
+            r.failures++;
+            continue;
+        }
+        solver.reset();
+        auto start = chrono::steady_clock::now();
+        int score = solver.solve(toSolverPosition(b));
+        r.seconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        r.nodes += solver.nodes;
+        if (score != expected) {
+            cout << "  " << moves << ": solver " << score << ", expected " << expected << "\n";
+            r.failures++;
+        }
+        if (checkMinimax) {
+            int got = minimaxOutcome(b, sideToMove(b));
+            if (got != outcome(expected)) {
+                cout << "  " << moves << ": minimax outcome " << got << ", expected " << outcome(expected) << "\n";
+                r.failures++;
+            }
+        }
+    }
+    return r;
+}
+
+int main(int argc, char** argv) {
+    string dir = getArgValue(argc, argv, "--dir", "tests/positions");
+    vector<string> sets;
+    for (int i = 1; i < argc; i++) {
+        string a = argv[i];
+        if (a == "--dir") { i++; continue; }
+        sets.push_back(a);
+    }
+    if (sets.empty()) sets = {"end_easy", "middle_easy", "middle_medium", "begin_easy", "begin_medium", "begin_hard"};
+
+    Solver solver;
+    int failures = 0;
+    printf(" %-14s %9s %9s %12s %14s\n", "set", "positions", "failures", "mean time", "mean nodes");
+    for (const string& name : sets) {
+        SetResult r = runSet(dir + "/" + name + ".txt", name == "end_easy", solver);
+        failures += r.failures;
+        int n = max(r.positions, 1);
+        printf(" %-14s %9d %9d %9.3f ms %14.0f\n", name.c_str(), r.positions, r.failures, 1000.0 * r.seconds / n, (double)r.nodes / n);
+    }
+    cout << (failures ? " FAILED\n" : " All positions solved correctly.\n");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,131 @@
+/*
+    CONNECT 4 - SHARED TRANSPOSITION TABLE STRESS TEST
+        First checks that packing an entry into one 64-bit word is lossless for
+        every field, including win scores and multi-four score-attack scores.
+
+        Then hammers the lock-free shared table from every core (at least 4
+        threads). Every stored entry's data is a function of its key, so any
+        probe that returns data not matching its key is a torn or misverified
+        entry. Tiny tables force constant collisions and overwrites, and entry
+        depths spread the keys over both the hot and the main tier.
+
+        Then checks that root-parallel search, which shares the table, returns
+        the same values as a serial search on the bench positions.
+
+        Build:  g++ -O3 -pthread -o tt_stress_test tests/tt_stress_test.cpp
+        Run:    ./tt_stress_test [--seconds 3] [--threads N]
+*/
+
+#define CONNECT4_NO_MAIN
+#include "../main.cpp"
+
+// Entry fully determined by the key, with every field in use
+MemoEntry entryFor(uint64_t key) {
+    uint64_t h = key * 0x9E3779B97F4A7C15ULL;
+    MemoEntry e = {(int)(h % COLS), (int)((int64_t)(h >> 32) % 100000000), (MemoBound)((h >> 8) % 3)};
+    e.depth = (int)((h >> 16) % (2 * (HOT_TT_MAX_DEPTH + 1))); // Half hot tier, half main tier
+    return e;
+}
+
+bool sameEntry(const MemoEntry& a, const MemoEntry& b) {
+    return a.col == b.col && a.score == b.score && a.bound == b.bound && a.depth == b.depth;
+}
+
+// Keys whose check bits all differ: with partial keys, two positions sharing
+// check bits and slot would be a (rare, legitimate) false hit, not a bug.
+vector<uint64_t> distinctKeys(size_t count) {
+    vector<uint64_t> keys;
+    unordered_set<uint64_t> checks;
+    for (uint64_t key = 1; keys.size() < count; key++)
+        if (checks.insert(slotIndex(key) >> KEY_CHECK_SHIFT).second) keys.push_back(key);
+    return keys;
+}
+
+int packingFailures() {
+    int failures = 0;
+    vector<int> scores = {0, 1, -1, 499999, 500000, -500000, 690000, -690000, 127 * FOUR_SCORE - 1, -127 * FOUR_SCORE};
+    for (int plies = 0; plies <= ROWS * COLS; plies++) {
+        scores.push_back(FOUR_SCORE - plies);   // Wins and losses, stored as plies to the end
+        scores.push_back(-FOUR_SCORE + plies);
+    }
+    for (int fours = -69; fours <= 69; fours++) scores.push_back(fours * FOUR_SCORE + 12345 * (fours % 3));
+    for (int score : scores) {
+        for (int col = -1; col < COLS; col++) {
+            MemoEntry e = {col, score, (MemoBound)((col + 1) % 3)};
+            e.depth = ROWS * COLS - (col + 1);
+            e.generation = (uint8_t)((col + 1) & GENERATION_MASK);
+            uint64_t hash = slotIndex(score * 7 + col), word;
+            if (!packMemoEntry(hash, e, word) || !packedEntryMatches(word, hash) ||
+                !sameEntry(unpackMemoEntry(word), e) || unpackMemoEntry(word).generation != e.generation) {
+                if (failures++ < 5) cout << "  packing lost score " << score << " col " << col << "\n";
+            }
+        }
+    }
+    return failures;
+}
+
+int main(int argc, char** argv) {
+    int seconds = getNumberArg<int>(argc, argv, "--seconds", 3);
+    int threads = getNumberArg<int>(argc, argv, "--threads", (int)max(4u, thread::hardware_concurrency()));
+
+    int failures = packingFailures();
+    cout << " Packing: " << (failures ? "FAILED" : "every field round-trips through one 64-bit entry") << "\n";
+    vector<uint64_t> keys = distinctKeys(200000);
+
+    TranspositionTable table;
+    table.resize(0, 1); // One main slot and 128 hot slots: every thread fights over the same entries
+    TranspositionTable wide;
+    wide.resize(1, 64); // 128K main and 8K hot slots, keys drawn from a few times that many
+
+    atomic<bool> stop(false);
+    atomic<uint64_t> probes(0), hits(0), corrupt(0), stores(0);
+    auto hammer = [&](int id) {
+        mt19937_64 rng(id + 1);
+        uint64_t p = 0, h = 0, c = 0, s = 0;
+        while (!stop.load(memory_order_relaxed)) {
+            for (int i = 0; i < 1024; i++) {
+                TranspositionTable& t = (i & 1) ? wide : table;
+                uint64_t key = keys[rng() % keys.size()];
+                MemoEntry e, expected = entryFor(key);
+                if (rng() & 1) {
+                    t.store(key, expected);
+                    s++;
+                } else {
+                    p++;
+                    if (t.find(key, expected.depth, e) != TT_MISS) {
+                        h++;
+                        if (!sameEntry(e, expected)) c++;
+                    }
+                }
+            }
+        }
+        probes += p; hits += h; corrupt += c; stores += s;
+    };
+
+    vector<thread> pool;
+    for (int t = 0; t < threads; t++) pool.emplace_back(hammer, t);
+    this_thread::sleep_for(chrono::seconds(seconds));
+    stop = true;
+    for (auto& t : pool) t.join();
+
+    cout << " Stress: " << threads << " threads, " << seconds << " s, " << stores.load() << " stores, "
+         << probes.load() << " probes, " << hits.load() << " hits, " << corrupt.load() << " corrupt reads\n";
+    failures += corrupt.load() > 0;
+
+    // Root-parallel search must agree with the serial search
+    for (const string& moves : BENCH_POSITIONS) {
+        char b[ROWS][COLS];
+        setBoardFromMoves(b, moves);
+        bool maximizingPlayer = (sideToMove(b) == 'O');
+        clearMemo();
+        int serial = parallelRootSearch(b, 7, maximizingPlayer, false, 1).second;
+        clearMemo();
+        int parallel = parallelRootSearch(b, 7, maximizingPlayer, false, threads).second;
+        if (serial != parallel) {
+            cout << "  " << moves << ": serial " << serial << ", parallel " << parallel << "\n";
+            failures++;
+        }
+    }
+    cout << (failures ? " FAILED\n" : " Shared table consistent; parallel search matches serial.\n");
+    return failures ? 1 : 0;
+}